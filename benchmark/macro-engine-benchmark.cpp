@@ -0,0 +1,478 @@
+// Headless benchmark of the macro condition engine.
+//
+// Synthesizes a set of macros with conditions of varying cost and drives them
+// for a fixed number of ticks using the different evaluation strategies the
+// plugin supports.
+// Conditions only burn CPU time and return deterministic results, so the
+// number of matching macros has to be identical for all strategies.
+
+#include "../src/headers/condition-logic.hpp"
+#include "../src/headers/macro-dependencies.hpp"
+#include "../src/headers/profiler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+static std::atomic<uint64_t> allocationCount = {0};
+
+void *operator new(size_t size)
+{
+	allocationCount++;
+	if (void *p = std::malloc(size ? size : 1)) {
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+	std::free(p);
+}
+
+enum class Mode {
+	SERIAL,
+	SHORT_CIRCUIT,
+	REORDER,
+	CONCURRENT,
+};
+
+static const char *getModeName(Mode mode)
+{
+	switch (mode) {
+	case Mode::SERIAL:
+		return "serial";
+	case Mode::SHORT_CIRCUIT:
+		return "short-circuit";
+	case Mode::REORDER:
+		return "reorder";
+	case Mode::CONCURRENT:
+		return "concurrent";
+	}
+	return "";
+}
+
+struct Options {
+	size_t macros = 100;
+	size_t conditions = 5;
+	size_t ticks = 1000;
+	// Busy loop iterations of a low cost condition
+	int work = 200;
+	// Chance of a condition to evaluate to true in percent
+	int matchChance = 50;
+	// Chance of a macro to refer to another macro in percent
+	int refChance = 10;
+	unsigned threads = std::max(2u, std::thread::hardware_concurrency());
+	uint32_t seed = 42;
+	bool profile = false;
+	std::vector<Mode> modes = {Mode::SERIAL, Mode::SHORT_CIRCUIT,
+				   Mode::REORDER, Mode::CONCURRENT};
+};
+
+struct SyntheticCondition {
+	LogicType logic;
+	ConditionCost cost;
+	bool skippable;
+	uint32_t seed;
+	std::string name;
+};
+
+struct SyntheticMacro {
+	std::vector<SyntheticCondition> conditions;
+	// Index of the macro the first condition is referring to
+	int ref = -1;
+	ConditionLogicChain chain;
+	std::atomic_bool matched = {false};
+};
+
+static uint32_t hash(uint32_t x)
+{
+	x ^= x >> 16;
+	x *= 0x7feb352d;
+	x ^= x >> 15;
+	x *= 0x846ca68b;
+	x ^= x >> 16;
+	return x;
+}
+
+static void busyWork(ConditionCost cost, int work)
+{
+	int iterations = work;
+	if (cost == ConditionCost::MEDIUM) {
+		iterations *= 10;
+	} else if (cost == ConditionCost::HIGH) {
+		iterations *= 100;
+	}
+	volatile uint32_t sink = 0;
+	for (int i = 0; i < iterations; i++) {
+		sink = sink * 31 + i;
+	}
+}
+
+static std::deque<SyntheticMacro> createMacros(const Options &o)
+{
+	std::mt19937 rng(o.seed);
+	std::uniform_int_distribution<int> percent(0, 99);
+	std::uniform_int_distribution<int> costDist(0, 9);
+	std::uniform_int_distribution<int> logicDist(0, 3);
+	const LogicType logicTypes[] = {LogicType::AND, LogicType::OR,
+					LogicType::AND_NOT, LogicType::AND};
+
+	std::deque<SyntheticMacro> macros(o.macros);
+	for (size_t i = 0; i < o.macros; i++) {
+		auto &macro = macros[i];
+		if (i > 0 && percent(rng) < o.refChance) {
+			macro.ref = std::uniform_int_distribution<int>(
+				0, (int)i - 1)(rng);
+		}
+		for (size_t j = 0; j < o.conditions; j++) {
+			SyntheticCondition c;
+			if (j == 0) {
+				c.logic = percent(rng) < 10 ? LogicType::ROOT_NOT
+							    : LogicType::ROOT_NONE;
+			} else {
+				c.logic = logicTypes[logicDist(rng)];
+			}
+			// Roughly mirror the distribution of condition costs
+			// of typical setups
+			int cost = costDist(rng);
+			c.cost = cost < 6   ? ConditionCost::LOW
+				 : cost < 9 ? ConditionCost::MEDIUM
+					    : ConditionCost::HIGH;
+			// Conditions using duration modifiers
+			c.skippable = percent(rng) >= 10;
+			c.seed = (uint32_t)rng();
+			c.name = "macro " + std::to_string(i) + " - " +
+				 std::to_string(j);
+			macro.conditions.emplace_back(std::move(c));
+		}
+	}
+	return macros;
+}
+
+// Minimal stand-in for the QThreadPool used by the plugin
+class WorkerPool {
+public:
+	WorkerPool(unsigned threads)
+	{
+		for (unsigned i = 0; i < threads; i++) {
+			_threads.emplace_back([this]() { Run(); });
+		}
+	}
+	~WorkerPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_stop = true;
+		}
+		_cv.notify_all();
+		for (auto &t : _threads) {
+			t.join();
+		}
+	}
+	void Start(std::function<void()> job)
+	{
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_jobs.emplace_back(std::move(job));
+			_pending++;
+		}
+		_cv.notify_one();
+	}
+	void WaitForDone()
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_doneCv.wait(lock, [this]() { return _pending == 0; });
+	}
+
+private:
+	void Run()
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		while (true) {
+			_cv.wait(lock, [this]() { return _stop || !_jobs.empty(); });
+			if (_stop) {
+				return;
+			}
+			auto job = std::move(_jobs.front());
+			_jobs.pop_front();
+			lock.unlock();
+			job();
+			lock.lock();
+			if (--_pending == 0) {
+				_doneCv.notify_all();
+			}
+		}
+	}
+
+	std::vector<std::thread> _threads;
+	std::deque<std::function<void()>> _jobs;
+	std::mutex _mutex;
+	std::condition_variable _cv;
+	std::condition_variable _doneCv;
+	size_t _pending = 0;
+	bool _stop = false;
+};
+
+class Benchmark {
+public:
+	Benchmark(const Options &o, Mode mode)
+		: _o(o), _mode(mode), _macros(createMacros(o))
+	{
+		_profiler.SetEnabled(o.profile);
+		if (mode != Mode::CONCURRENT) {
+			return;
+		}
+		std::vector<MacroDependencies> dependencies(_macros.size());
+		for (size_t i = 0; i < _macros.size(); i++) {
+			if (_macros[i].ref >= 0) {
+				dependencies[i].macros.push_back(_macros[i].ref);
+			}
+		}
+		_levels = getMacroCheckLevels(dependencies);
+		_pool = std::make_unique<WorkerPool>(o.threads);
+	}
+
+	void Run();
+
+private:
+	bool CheckMacro(SyntheticMacro &macro);
+	void Tick();
+	void TickConcurrently();
+
+	const Options &_o;
+	Mode _mode;
+	std::deque<SyntheticMacro> _macros;
+	std::vector<int> _levels;
+	std::unique_ptr<WorkerPool> _pool;
+	Profiler _profiler;
+	uint32_t _tick = 0;
+	std::atomic<uint64_t> _checks = {0};
+	uint64_t _matches = 0;
+};
+
+bool Benchmark::CheckMacro(SyntheticMacro &macro)
+{
+	auto &chain = macro.chain;
+	chain.Clear();
+	for (const auto &c : macro.conditions) {
+		chain.Add(c.logic, c.cost, c.skippable);
+	}
+
+	auto check = [&](size_t idx) {
+		auto start = std::chrono::high_resolution_clock::now();
+		const auto &c = macro.conditions[idx];
+		busyWork(c.cost, _o.work);
+		bool result;
+		if (idx == 0 && macro.ref >= 0) {
+			result = _macros[macro.ref].matched;
+		} else {
+			result = (int)(hash(c.seed ^ _tick) % 100) <
+				 _o.matchChance;
+		}
+		_checks++;
+		if (_profiler.Enabled()) {
+			_profiler.AddSample(ProfilerCategory::CONDITION, c.name,
+					    msSince(start));
+		}
+		return result;
+	};
+
+	bool shortCircuit = _mode != Mode::SERIAL;
+	bool reorder = _mode == Mode::REORDER || _mode == Mode::CONCURRENT;
+	macro.matched = chain.Evaluate(shortCircuit, reorder, check);
+	return macro.matched;
+}
+
+void Benchmark::Tick()
+{
+	for (auto &macro : _macros) {
+		if (CheckMacro(macro)) {
+			_matches++;
+		}
+	}
+}
+
+void Benchmark::TickConcurrently()
+{
+	int maxLevel = -1;
+	for (auto level : _levels) {
+		maxLevel = std::max(maxLevel, level);
+	}
+	for (int level = 0; level <= maxLevel; level++) {
+		for (size_t i = 0; i < _macros.size(); i++) {
+			if (_levels[i] != level) {
+				continue;
+			}
+			auto macro = &_macros[i];
+			_pool->Start([this, macro]() { CheckMacro(*macro); });
+		}
+		_pool->WaitForDone();
+	}
+	for (auto &macro : _macros) {
+		if (macro.matched) {
+			_matches++;
+		}
+	}
+}
+
+static void printHeader()
+{
+	std::printf("%-14s %10s %12s %12s %10s %10s %10s %10s\n", "mode",
+		    "ticks/s", "allocs/tick", "checks/tick", "p50 [ms]",
+		    "p95 [ms]", "max [ms]", "matches");
+}
+
+void Benchmark::Run()
+{
+	ProfilerSampleWindow tickTimes;
+	std::vector<double> samples;
+	samples.reserve(_o.ticks);
+
+	uint64_t allocationsBefore = allocationCount;
+	auto start = std::chrono::high_resolution_clock::now();
+	for (_tick = 0; _tick < _o.ticks; _tick++) {
+		auto tickStart = std::chrono::high_resolution_clock::now();
+		if (_mode == Mode::CONCURRENT) {
+			TickConcurrently();
+		} else {
+			Tick();
+		}
+		double ms = msSince(tickStart);
+		samples.push_back(ms);
+		if (_profiler.Enabled()) {
+			_profiler.AddSample(ProfilerCategory::TICK, "benchmark",
+					    ms);
+		}
+	}
+	double totalMs = msSince(start);
+	uint64_t allocations = allocationCount - allocationsBefore;
+
+	std::sort(samples.begin(), samples.end());
+	auto percentile = [&samples](double p) {
+		if (samples.empty()) {
+			return 0.;
+		}
+		return samples[(size_t)(p * (samples.size() - 1))];
+	};
+
+	double ticks = (double)std::max<size_t>(_o.ticks, 1);
+	std::printf(
+		"%-14s %10.1f %12.1f %12.1f %10.3f %10.3f %10.3f %10llu\n",
+		getModeName(_mode), _o.ticks / (totalMs / 1000.),
+		allocations / ticks, _checks / ticks, percentile(0.5),
+		percentile(0.95), samples.empty() ? 0. : samples.back(),
+		(unsigned long long)_matches);
+
+	if (_profiler.Enabled()) {
+		std::printf("%s\n", _profiler.ToCSV().c_str());
+	}
+}
+
+static void printUsage(const char *name)
+{
+	std::printf(
+		"Usage: %s [options]\n"
+		"  --macros N       number of macros (default 100)\n"
+		"  --conditions N   conditions per macro (default 5)\n"
+		"  --ticks N        number of ticks to run (default 1000)\n"
+		"  --work N         busy loop iterations of a cheap "
+		"condition (default 200)\n"
+		"  --match N        chance of a condition to match in "
+		"percent (default 50)\n"
+		"  --refs N         chance of a macro to refer to another "
+		"macro in percent (default 10)\n"
+		"  --threads N      worker threads of the concurrent mode\n"
+		"  --seed N         seed used to generate the macros\n"
+		"  --mode M         serial, short-circuit, reorder, "
+		"concurrent or all (default all)\n"
+		"  --profile        print per condition statistics\n",
+		name);
+}
+
+static bool parseMode(const char *value, std::vector<Mode> &modes)
+{
+	if (std::strcmp(value, "all") == 0) {
+		modes = {Mode::SERIAL, Mode::SHORT_CIRCUIT, Mode::REORDER,
+			 Mode::CONCURRENT};
+		return true;
+	}
+	for (auto mode : {Mode::SERIAL, Mode::SHORT_CIRCUIT, Mode::REORDER,
+			  Mode::CONCURRENT}) {
+		if (std::strcmp(value, getModeName(mode)) == 0) {
+			modes = {mode};
+			return true;
+		}
+	}
+	return false;
+}
+
+int main(int argc, char **argv)
+{
+	Options o;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--profile") {
+			o.profile = true;
+			continue;
+		}
+		if (arg == "--help" || i + 1 >= argc) {
+			printUsage(argv[0]);
+			return arg == "--help" ? 0 : 1;
+		}
+		const char *value = argv[++i];
+		if (arg == "--macros") {
+			o.macros = std::strtoul(value, nullptr, 10);
+		} else if (arg == "--conditions") {
+			o.conditions = std::strtoul(value, nullptr, 10);
+		} else if (arg == "--ticks") {
+			o.ticks = std::strtoul(value, nullptr, 10);
+		} else if (arg == "--work") {
+			o.work = std::atoi(value);
+		} else if (arg == "--match") {
+			o.matchChance = std::atoi(value);
+		} else if (arg == "--refs") {
+			o.refChance = std::atoi(value);
+		} else if (arg == "--threads") {
+			o.threads = std::max(1, std::atoi(value));
+		} else if (arg == "--seed") {
+			o.seed = std::strtoul(value, nullptr, 10);
+		} else if (arg == "--mode") {
+			if (!parseMode(value, o.modes)) {
+				printUsage(argv[0]);
+				return 1;
+			}
+		} else {
+			printUsage(argv[0]);
+			return 1;
+		}
+	}
+
+	std::printf("%zu macros, %zu conditions each, %zu ticks, seed %u\n",
+		    o.macros, o.conditions, o.ticks, o.seed);
+	printHeader();
+	for (auto mode : o.modes) {
+		Benchmark benchmark(o, mode);
+		benchmark.Run();
+	}
+	return 0;
+}
@@ -2,7 +2,6 @@
 #include <QAction>
 #include <QFileDialog>
 #include <QDirIterator>
-#include <regex>
 #include <filesystem>
 
 #include <obs-module.h>
@@ -10,7 +9,10 @@
 
 #include "headers/advanced-scene-switcher.hpp"
 #include "headers/status-control.hpp"
+#include "headers/regex-cache.hpp"
+#include "headers/profiler-dock.hpp"
 #include "headers/curl-helper.hpp"
+#include "headers/http-fetcher.hpp"
 #include "headers/utility.hpp"
 #include "headers/version.h"
 
@@ -173,9 +175,41 @@ void SwitcherData::Thread()
 			}
 		}
 
+		updateWakeupEvents();
+		if (!sleep && !pollingRequired &&
+		    duration.count() < event_driven_fallback_interval) {
+			duration = std::chrono::milliseconds(
+				event_driven_fallback_interval);
+		}
+
 		vblog(LOG_INFO, "try to sleep for %ld", duration.count());
 		setWaitScene();
-		cv.wait_for(lock, duration);
+		if (sleep || linger) {
+			// Delays requested by legacy switches are only cut
+			// short by manual scene changes and the following check
+			// also covers the events reported in the meantime
+			cv.wait_for(lock, duration, [this] {
+				return stop || sceneChangedDuringWait();
+			});
+			clearWakeup();
+		} else {
+			// Never delay checks triggered by events longer than
+			// the regular check interval
+			auto minWakeupInterval = std::chrono::milliseconds(
+				std::min(min_wakeup_interval, interval));
+			auto nextWakeupCheck = startTime + minWakeupInterval;
+			lock.unlock();
+			waitForWakeup(duration, nextWakeupCheck);
+
+			// The UI thread is most likely to take the lock while
+			// the switcher thread is waiting
+			auto lockStartTime =
+				std::chrono::high_resolution_clock::now();
+			lock.lock();
+			profiler.AddSample(ProfilerCategory::LOCK_WAIT,
+					   "switcher thread",
+					   msSince(lockStartTime));
+		}
 
 		startTime = std::chrono::high_resolution_clock::now();
 		sleep = 0;
@@ -203,7 +237,9 @@ void SwitcherData::Thread()
 			      duration.count());
 
 			setWaitScene();
-			cv.wait_for(lock, duration);
+			cv.wait_for(lock, duration, [this] {
+				return stop || sceneChangedDuringWait();
+			});
 
 			if (stop) {
 				break;
@@ -242,6 +278,8 @@ void SwitcherData::Thread()
 		}
 
 		writeSceneInfoToFile();
+		profiler.AddSample(ProfilerCategory::TICK, "switcher thread",
+				   msSince(startTime));
 	}
 
 	blog(LOG_INFO, "stopped");
@@ -255,21 +293,15 @@ void SwitcherData::setPreconditions()
 	GetCurrentWindowTitle(title);
 	for (auto &window : ignoreWindowsSwitches) {
 		bool equals = (title == window);
-		bool matches = false;
-		if (!equals) {
-			try {
-				std::regex expr(window);
-				matches = std::regex_match(title, expr);
-
-			} catch (const std::regex_error &) {
-			}
-		}
+		bool matches = !equals && matchRegex(title, window);
 		if (equals || matches) {
 			title = lastTitle;
 			break;
 		}
 	}
 	currentTitle = title;
+	windowListValid = false;
+	processListValid = false;
 
 	// Cursor
 	std::pair<int, int> cursorPos = getCursorPos();
@@ -278,6 +310,65 @@ void SwitcherData::setPreconditions()
 	lastCursorPos = getCursorPos();
 }
 
+const std::vector<std::string> &SwitcherData::getWindowList()
+{
+	if (!windowListValid) {
+		GetWindowList(windowList);
+		windowListValid = true;
+	}
+	return windowList;
+}
+
+const QStringList &SwitcherData::getProcessList()
+{
+	if (!processListValid) {
+		GetProcessList(processList);
+		processNames.clear();
+		for (const auto &process : processList) {
+			processNames.insert(process);
+		}
+		processListValid = true;
+	}
+	return processList;
+}
+
+bool SwitcherData::isProcessRunning(const QString &name)
+{
+	getProcessList();
+	return processNames.contains(name);
+}
+
+static const char *getSwitchFuncName(int func)
+{
+	switch (func) {
+	case read_file_func:
+		return "file";
+	case idle_func:
+		return "idle";
+	case exe_func:
+		return "executable";
+	case screen_region_func:
+		return "screen region";
+	case window_title_func:
+		return "window title";
+	case round_trip_func:
+		return "scene sequence";
+	case media_func:
+		return "media";
+	case time_func:
+		return "time";
+	case audio_func:
+		return "audio";
+	case video_func:
+		return "video";
+	case macro_func:
+		return "macros";
+	default:
+		break;
+	}
+	return "unknown";
+}
+
 bool SwitcherData::checkForMatch(OBSWeakSource &scene,
 				 OBSWeakSource &transition, int &linger,
 				 bool &setPrevSceneAfterLinger,
@@ -294,6 +385,7 @@ bool SwitcherData::checkForMatch(OBSWeakSource &scene,
 	}
 
 	for (int switchFuncName : functionNamesByPriority) {
+		auto funcStartTime = std::chrono::high_resolution_clock::now();
 		switch (switchFuncName) {
 		case read_file_func:
 			match = checkSwitchInfoFromFile(scene, transition) ||
@@ -334,6 +426,11 @@ bool SwitcherData::checkForMatch(OBSWeakSource &scene,
 			}
 			break;
 		}
+		if (profiler.Enabled()) {
+			profiler.AddSample(ProfilerCategory::LEGACY_SWITCH,
+					   getSwitchFuncName(switchFuncName),
+					   msSince(funcStartTime));
+		}
 
 		if (stop) {
 			return false;
@@ -423,6 +520,7 @@ void SwitcherData::Stop()
 	if (th && th->isRunning()) {
 		stop = true;
 		cv.notify_all();
+		Wakeup();
 		abortMacroWait = true;
 		macroWaitCv.notify_all();
 		macroTransitionCv.notify_all();
@@ -444,6 +542,79 @@ void SwitcherData::Stop()
 	}
 }
 
+void SwitcherData::Wakeup(WakeupEvent event)
+{
+	if (event != WakeupEvent::ALL &&
+	    !hasWakeupEvent(wakeupEvents, event)) {
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(wakeupMutex);
+		wakeup = true;
+	}
+	wakeupCv.notify_one();
+}
+
+void SwitcherData::waitForWakeup(
+	std::chrono::milliseconds duration,
+	std::chrono::high_resolution_clock::time_point earliestCheck)
+{
+	std::unique_lock<std::mutex> lock(wakeupMutex);
+	wakeupCv.wait_for(lock, duration, [this] { return stop || wakeup; });
+	if (stop || !wakeup) {
+		return;
+	}
+
+	// Further events until the minimum time between checks has passed are
+	// handled by the same check
+	wakeupCv.wait_until(lock, earliestCheck, [this] { return stop; });
+	wakeup = false;
+}
+
+void SwitcherData::clearWakeup()
+{
+	std::lock_guard<std::mutex> lock(wakeupMutex);
+	wakeup = false;
+}
+
+void NotifyWindowChange()
+{
+	if (switcher) {
+		switcher->Wakeup(WakeupEvent::WINDOW_CHANGE);
+	}
+}
+
+bool SwitcherData::legacySwitchesConfigured()
+{
+	return !windowSwitches.empty() || !screenRegionSwitches.empty() ||
+	       !sceneSequenceSwitches.empty() || !randomSwitches.empty() ||
+	       !fileSwitches.empty() || !executableSwitches.empty() ||
+	       !mediaSwitches.empty() || !pauseEntries.empty() ||
+	       !timeSwitches.empty() || !audioSwitches.empty() ||
+	       !videoSwitches.empty() || idleData.idleEnable ||
+	       fileIO.readEnabled || switchIfNotMatching != NO_SWITCH;
+}
+
+void SwitcherData::updateWakeupEvents()
+{
+	// The legacy switches do not provide any information about the events
+	// they depend on, so they have to be polled
+	if (legacySwitchesConfigured()) {
+		wakeupEvents = WakeupEvent::ALL;
+		pollingRequired = true;
+		return;
+	}
+
+	WakeupEvent events = WakeupEvent::NONE;
+	bool polling = false;
+	for (auto &m : macros) {
+		events = events | m->GetWakeupEvents();
+		polling = polling || m->RequiresPolling();
+	}
+	wakeupEvents = events;
+	pollingRequired = polling;
+}
+
 void SwitcherData::setWaitScene()
 {
 	waitScene = obs_frontend_get_current_scene();
@@ -479,6 +650,7 @@ bool SwitcherData::anySceneTransitionStarted()
 extern "C" void FreeSceneSwitcher()
 {
 	if (loaded_curl_lib) {
+		HttpFetcher::Stop();
 		if (switcher->curl && f_curl_cleanup) {
 			f_curl_cleanup(switcher->curl);
 		}
@@ -497,7 +669,7 @@ void handleSceneChange()
 	switcher->lastSceneChangeTime =
 		std::chrono::high_resolution_clock::now();
 
-	// Stop waiting if scene was changed
+	// Stop the delays of legacy switches if the scene was changed
 	if (switcher->sceneChangedDuringWait()) {
 		switcher->cv.notify_one();
 	}
@@ -520,6 +692,7 @@ void handleSceneChange()
 
 	switcher->checkTriggers();
 	switcher->checkDefaultSceneTransitions();
+	switcher->Wakeup(WakeupEvent::SCENE_CHANGE);
 
 	if (switcher->networkConfig.ShouldSendFrontendSceneChange()) {
 		switcher->server.sendMessage({ws, nullptr, 0});
@@ -571,6 +744,7 @@ void setTranstionEnd()
 	switcher->lastTransitionEndTime =
 		std::chrono::high_resolution_clock::now();
 	switcher->macroTransitionCv.notify_all();
+	switcher->Wakeup(WakeupEvent::TRANSITION);
 }
 
 void setStreamStarting()
@@ -689,6 +863,7 @@ extern "C" void InitSceneSwitcher()
 	PlatformInit();
 	LoadPlugins();
 	SetupDock();
+	SetupProfilerDock();
 
 	auto cb = []() {
 		if (switcher->settingsWindowOpened) {
@@ -0,0 +1,193 @@
+#include "headers/audio-fade.hpp"
+#include "headers/advanced-scene-switcher.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+// Volumes below this level are treated as silence for logarithmic fades
+constexpr double minFadeDb = -60.;
+
+static std::mutex fadeMutex;
+static std::condition_variable fadeCV;
+static std::vector<std::shared_ptr<AudioFade>> fades;
+static bool tickActive = false;
+
+AudioFade::AudioFade(Macro *macro, const OBSWeakSource &source, float volume,
+		     double seconds, FadeCurve curve)
+	: _macro(macro),
+	  _source(source),
+	  _startVolume(GetVolume(source)),
+	  _endVolume(volume),
+	  _seconds(seconds),
+	  _curve(curve),
+	  _startTime(std::chrono::high_resolution_clock::now())
+{
+}
+
+std::shared_ptr<AudioFade> AudioFade::Start(Macro *macro,
+					    const OBSWeakSource &source,
+					    float volume, double seconds,
+					    FadeCurve curve, bool abortActive)
+{
+	std::shared_ptr<AudioFade> fade(
+		new AudioFade(macro, source, volume, seconds, curve));
+	bool addTick = false;
+	{
+		std::lock_guard<std::mutex> lock(fadeMutex);
+		auto it = std::find_if(fades.begin(), fades.end(),
+				       [&source](const auto &f) {
+					       return f->_source.Get() ==
+						      source.Get();
+				       });
+		if (it != fades.end()) {
+			if (!abortActive) {
+				return nullptr;
+			}
+			(*it)->_done = true;
+			fades.erase(it);
+			fadeCV.notify_all();
+		}
+
+		if (seconds <= 0.) {
+			SetVolume(source, volume);
+			fade->_done = true;
+			return fade;
+		}
+
+		fades.push_back(fade);
+		addTick = !tickActive;
+		tickActive = true;
+	}
+
+	// Must not be called while holding fadeMutex as OBS holds its own lock
+	// while calling the tick callbacks
+	if (addTick) {
+		obs_add_tick_callback(Tick, nullptr);
+	}
+	return fade;
+}
+
+void AudioFade::Stop(Macro *macro)
+{
+	std::lock_guard<std::mutex> lock(fadeMutex);
+	auto it = std::remove_if(fades.begin(), fades.end(),
+				 [macro](const auto &f) {
+					 if (f->_macro != macro) {
+						 return false;
+					 }
+					 f->_done = true;
+					 return true;
+				 });
+	if (it != fades.end()) {
+		fades.erase(it, fades.end());
+		fadeCV.notify_all();
+	}
+	// The tick callback will remove itself once no fades are left
+}
+
+float AudioFade::GetVolume(const OBSWeakSource &source)
+{
+	if (!source) {
+		return obs_get_master_volume();
+	}
+
+	auto s = obs_weak_source_get_source(source);
+	if (!s) {
+		return 0.f;
+	}
+	float volume = obs_source_get_volume(s);
+	obs_source_release(s);
+	return volume;
+}
+
+void AudioFade::SetVolume(const OBSWeakSource &source, float volume)
+{
+	if (!source) {
+		obs_set_master_volume(volume);
+		return;
+	}
+
+	auto s = obs_weak_source_get_source(source);
+	obs_source_set_volume(s, volume);
+	obs_source_release(s);
+}
+
+void AudioFade::Wait()
+{
+	std::unique_lock<std::mutex> lock(fadeMutex);
+	fadeCV.wait(lock, [this]() { return _done.load(); });
+}
+
+void AudioFade::Tick(void *, float)
+{
+	const auto now = std::chrono::high_resolution_clock::now();
+	bool removeTick = false;
+	{
+		std::lock_guard<std::mutex> lock(fadeMutex);
+		bool completed = false;
+		for (auto it = fades.begin(); it != fades.end();) {
+			if ((*it)->Update(now)) {
+				(*it)->_done = true;
+				it = fades.erase(it);
+				completed = true;
+			} else {
+				++it;
+			}
+		}
+		if (completed) {
+			fadeCV.notify_all();
+		}
+		if (fades.empty()) {
+			tickActive = false;
+			removeTick = true;
+		}
+	}
+
+	if (removeTick) {
+		obs_remove_tick_callback(Tick, nullptr);
+	}
+}
+
+bool AudioFade::Update(std::chrono::high_resolution_clock::time_point now)
+{
+	const double progress =
+		std::chrono::duration<double>(now - _startTime).count() /
+		_seconds;
+	if (progress >= 1.) {
+		SetVolume(_source, _endVolume);
+		return true;
+	}
+	SetVolume(_source, GetVolumeAt(progress));
+	return false;
+}
+
+static double volumeToDb(float volume)
+{
+	if (volume <= 0.f) {
+		return minFadeDb;
+	}
+	double db = 20. * std::log10(volume);
+	return db < minFadeDb ? minFadeDb : db;
+}
+
+float AudioFade::GetVolumeAt(double progress) const
+{
+	switch (_curve) {
+	case FadeCurve::LOGARITHMIC: {
+		const double startDb = volumeToDb(_startVolume);
+		const double endDb = volumeToDb(_endVolume);
+		const double db = startDb + (endDb - startDb) * progress;
+		return (float)std::pow(10., db / 20.);
+	}
+	case FadeCurve::S_CURVE:
+		progress = progress * progress * (3. - 2. * progress);
+		break;
+	case FadeCurve::LINEAR:
+	default:
+		break;
+	}
+	return _startVolume + (_endVolume - _startVolume) * (float)progress;
+}
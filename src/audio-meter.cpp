@@ -0,0 +1,341 @@
+#include "headers/audio-meter.hpp"
+#include "headers/advanced-scene-switcher.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <mutex>
+
+static std::mutex registryMutex;
+static std::map<obs_weak_source_t *, std::weak_ptr<AudioMeter>> registry;
+
+static int64_t now()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		       std::chrono::high_resolution_clock::now()
+			       .time_since_epoch())
+		.count();
+}
+
+void AudioLevelRing::Push(int64_t time, float first, float second)
+{
+	// There is only a single writer, so no read-modify-write is necessary
+	const uint64_t idx = _writeCount.load(std::memory_order_relaxed);
+	auto &entry = _entries[idx % _capacity];
+
+	entry.sequence.store(2 * idx + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	entry.time.store(time, std::memory_order_relaxed);
+	entry.first.store(first, std::memory_order_relaxed);
+	entry.second.store(second, std::memory_order_relaxed);
+	entry.sequence.store(2 * idx + 2, std::memory_order_release);
+
+	_writeCount.store(idx + 1, std::memory_order_release);
+}
+
+std::shared_ptr<AudioMeter> AudioMeter::Get(const OBSWeakSource &source)
+{
+	if (!source) {
+		return nullptr;
+	}
+
+	std::lock_guard<std::mutex> lock(registryMutex);
+	auto it = registry.find(source);
+	if (it != registry.end()) {
+		if (auto meter = it->second.lock()) {
+			return meter;
+		}
+	}
+
+	std::shared_ptr<AudioMeter> meter(new AudioMeter(source));
+	registry[source] = meter;
+	return meter;
+}
+
+AudioMeter::AudioMeter(const OBSWeakSource &source) : _source(source)
+{
+	_volmeter = obs_volmeter_create(OBS_FADER_LOG);
+	obs_volmeter_add_callback(_volmeter, SetVolumeLevel, this);
+	obs_source_t *as = obs_weak_source_get_source(source);
+	if (!obs_volmeter_attach_source(_volmeter, as)) {
+		const char *name = obs_source_get_name(as);
+		blog(LOG_WARNING, "failed to attach volmeter to source %s",
+		     name);
+	}
+	obs_source_release(as);
+}
+
+AudioMeter::~AudioMeter()
+{
+	obs_volmeter_remove_callback(_volmeter, SetVolumeLevel, this);
+	obs_volmeter_destroy(_volmeter);
+
+	if (_loudnessUsers > 0) {
+		obs_source_t *as = obs_weak_source_get_source(_source);
+		obs_source_remove_audio_capture_callback(as, ProcessAudio,
+							 this);
+		obs_source_release(as);
+	}
+
+	std::lock_guard<std::mutex> lock(registryMutex);
+	auto it = registry.find(_source);
+	if (it != registry.end() && it->second.expired()) {
+		registry.erase(it);
+	}
+}
+
+double AudioMeter::PeakToVolume(float peak)
+{
+	return ((double)peak + 60) * 1.7;
+}
+
+void AudioMeter::SetVolumeLevel(void *data,
+				const float magnitude[MAX_AUDIO_CHANNELS],
+				const float peak[MAX_AUDIO_CHANNELS],
+				const float *)
+{
+	auto meter = static_cast<AudioMeter *>(data);
+
+	float currentPeak = -std::numeric_limits<float>::infinity();
+	float currentMagnitude = -std::numeric_limits<float>::infinity();
+	for (int i = 0; i < MAX_AUDIO_CHANNELS; i++) {
+		if (peak[i] > currentPeak) {
+			currentPeak = peak[i];
+		}
+		if (magnitude[i] > currentMagnitude) {
+			currentMagnitude = magnitude[i];
+		}
+	}
+
+	meter->_levels.Push(now(), currentPeak, currentMagnitude);
+	meter->CheckWakeupThresholds(currentPeak);
+}
+
+static double dbToPower(float db)
+{
+	return std::pow(10., db / 10.);
+}
+
+static double dbToAmplitude(float db)
+{
+	return std::pow(10., db / 20.);
+}
+
+static int64_t windowStart(std::chrono::milliseconds window)
+{
+	return now() -
+	       std::chrono::duration_cast<std::chrono::nanoseconds>(window)
+		       .count();
+}
+
+AudioLevelStats AudioMeter::GetStats(std::chrono::milliseconds window) const
+{
+	AudioLevelStats stats;
+	double amplitudeSum = 0.;
+	double powerSum = 0.;
+	_levels.ForEach(windowStart(window), [&](float peak, float magnitude) {
+		if (peak > stats.maxPeak) {
+			stats.maxPeak = peak;
+		}
+		amplitudeSum += dbToAmplitude(peak);
+		powerSum += dbToPower(magnitude);
+		stats.count++;
+	});
+
+	if (stats.count > 0) {
+		stats.avgPeak = 20. * std::log10(amplitudeSum / stats.count);
+		stats.rms = 10. * std::log10(powerSum / stats.count);
+	}
+	return stats;
+}
+
+static int volumeToThreshold(double volume, int max)
+{
+	if (volume < 0) {
+		return 0;
+	}
+	if (volume > max) {
+		return max;
+	}
+	return static_cast<int>(volume);
+}
+
+void AudioMeter::AddWakeupThreshold(int threshold)
+{
+	_thresholds[volumeToThreshold(threshold, _maxThreshold)]++;
+	_thresholdCount++;
+}
+
+void AudioMeter::RemoveWakeupThreshold(int threshold)
+{
+	_thresholds[volumeToThreshold(threshold, _maxThreshold)]--;
+	_thresholdCount--;
+}
+
+void AudioMeter::CheckWakeupThresholds(float peak)
+{
+	const double lastVolume = PeakToVolume(_lastPeak);
+	const double volume = PeakToVolume(peak);
+	_lastPeak = peak;
+
+	if (_thresholdCount == 0) {
+		return;
+	}
+
+	// Only wake up the switcher thread if one of the configured thresholds
+	// was crossed to avoid checking the conditions on every volume update
+	for (int threshold = 0; threshold <= _maxThreshold; threshold++) {
+		if (_thresholds[threshold] == 0) {
+			continue;
+		}
+		if ((lastVolume > threshold) != (volume > threshold)) {
+			if (auto data = GetSwitcher()) {
+				data->Wakeup(WakeupEvent::AUDIO_LEVEL);
+			}
+			return;
+		}
+	}
+}
+
+void AudioMeter::EnableLoudness()
+{
+	std::lock_guard<std::mutex> lock(_loudnessMutex);
+	if (_loudnessUsers++ > 0) {
+		return;
+	}
+
+	// The audio callback is not active, so the filter state can be reset
+	_filterSampleRate = 0;
+	obs_source_t *as = obs_weak_source_get_source(_source);
+	obs_source_add_audio_capture_callback(as, ProcessAudio, this);
+	obs_source_release(as);
+}
+
+void AudioMeter::DisableLoudness()
+{
+	std::lock_guard<std::mutex> lock(_loudnessMutex);
+	if (_loudnessUsers == 0 || --_loudnessUsers > 0) {
+		return;
+	}
+
+	obs_source_t *as = obs_weak_source_get_source(_source);
+	obs_source_remove_audio_capture_callback(as, ProcessAudio, this);
+	obs_source_release(as);
+}
+
+double AudioMeter::GetLoudness(std::chrono::milliseconds window) const
+{
+	double energy = 0.;
+	double frames = 0.;
+	_loudness.ForEach(windowStart(window),
+			  [&](float power, float blockFrames) {
+				  energy += (double)power * blockFrames;
+				  frames += blockFrames;
+			  });
+
+	if (frames == 0.) {
+		return -std::numeric_limits<double>::infinity();
+	}
+	return -0.691 + 10. * std::log10(energy / frames);
+}
+
+// Coefficients of the K-weighting pre-filter and RLB high-pass filter for
+// arbitrary sample rates as described in ITU-R BS.1770
+void AudioMeter::UpdateFilters(uint32_t sampleRate)
+{
+	constexpr double pi = 3.14159265358979323846;
+	double f0 = 1681.974450955533;
+	double G = 3.999843853973347;
+	double Q = 0.7071752369554196;
+	double K = std::tan(pi * f0 / sampleRate);
+	double Vh = std::pow(10., G / 20.);
+	double Vb = std::pow(Vh, 0.4996667741545416);
+	double a0 = 1. + K / Q + K * K;
+
+	auto &shelf = _filters[0];
+	shelf.b[0] = (Vh + Vb * K / Q + K * K) / a0;
+	shelf.b[1] = 2. * (K * K - Vh) / a0;
+	shelf.b[2] = (Vh - Vb * K / Q + K * K) / a0;
+	shelf.a[1] = 2. * (K * K - 1.) / a0;
+	shelf.a[2] = (1. - K / Q + K * K) / a0;
+
+	f0 = 38.13547087602444;
+	Q = 0.5003270373238773;
+	K = std::tan(pi * f0 / sampleRate);
+	a0 = 1. + K / Q + K * K;
+
+	auto &highPass = _filters[1];
+	highPass.b[0] = 1.;
+	highPass.b[1] = -2.;
+	highPass.b[2] = 1.;
+	highPass.a[1] = 2. * (K * K - 1.) / a0;
+	highPass.a[2] = (1. - K / Q + K * K) / a0;
+
+	memset(_filterState, 0, sizeof(_filterState));
+	_filterSampleRate = sampleRate;
+}
+
+static bool isLfeChannel(enum speaker_layout speakers, size_t channel)
+{
+	switch (speakers) {
+	case SPEAKERS_2POINT1:
+		return channel == 2;
+	case SPEAKERS_4POINT1:
+	case SPEAKERS_5POINT1:
+	case SPEAKERS_7POINT1:
+		return channel == 3;
+	default:
+		return false;
+	}
+}
+
+void AudioMeter::ProcessAudio(void *data, obs_source_t *source,
+			      const struct audio_data *audio, bool muted)
+{
+	auto meter = static_cast<AudioMeter *>(data);
+	if (audio->frames == 0) {
+		return;
+	}
+
+	// Audio data is always passed on in the planar float format of the
+	// OBS audio output
+	const audio_output_info *info = audio_output_get_info(obs_get_audio());
+	if (info->samples_per_sec != meter->_filterSampleRate) {
+		meter->UpdateFilters(info->samples_per_sec);
+	}
+	const size_t channels = audio_output_get_channels(obs_get_audio());
+	const float volume = muted ? 0.f : obs_source_get_volume(source);
+
+	double power = 0.;
+	for (size_t ch = 0; ch < channels && ch < MAX_AUDIO_CHANNELS; ch++) {
+		auto samples = reinterpret_cast<const float *>(audio->data[ch]);
+		if (!samples) {
+			continue;
+		}
+
+		double sum = 0.;
+		for (uint32_t i = 0; i < audio->frames; i++) {
+			double sample = (double)samples[i] * volume;
+			for (int stage = 0; stage < 2; stage++) {
+				const auto &f = meter->_filters[stage];
+				// x1, x2, y1, y2
+				double *z = meter->_filterState[ch][stage];
+				double out = f.b[0] * sample + f.b[1] * z[0] +
+					     f.b[2] * z[1] - f.a[1] * z[2] -
+					     f.a[2] * z[3];
+				z[1] = z[0];
+				z[0] = sample;
+				z[3] = z[2];
+				z[2] = out;
+				sample = out;
+			}
+			sum += sample * sample;
+		}
+
+		if (!isLfeChannel(info->speakers, ch)) {
+			power += sum / audio->frames;
+		}
+	}
+
+	meter->_loudness.Push(now(), (float)power, (float)audio->frames);
+}
@@ -0,0 +1,178 @@
+#include "headers/condition-logic.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+static bool isAndLogic(LogicType l)
+{
+	return l == LogicType::AND || l == LogicType::AND_NOT;
+}
+
+static bool isOrLogic(LogicType l)
+{
+	return l == LogicType::OR || l == LogicType::OR_NOT;
+}
+
+static bool combine(LogicType logic, bool matched, bool value)
+{
+	switch (logic) {
+	case LogicType::ROOT_NONE:
+		return value;
+	case LogicType::ROOT_NOT:
+		return !value;
+	case LogicType::AND:
+		return matched && value;
+	case LogicType::OR:
+		return matched || value;
+	case LogicType::AND_NOT:
+		return matched && !value;
+	case LogicType::OR_NOT:
+		// Keep behaviour of previous versions
+		return matched;
+	default:
+		break;
+	}
+	return matched;
+}
+
+static bool resultCanChange(LogicType logic, bool matched)
+{
+	if (isAndLogic(logic)) {
+		return matched;
+	}
+	if (isOrLogic(logic)) {
+		return !matched;
+	}
+	return isRootLogicType(logic);
+}
+
+void ConditionLogicChain::Clear()
+{
+	_entries.clear();
+}
+
+void ConditionLogicChain::Add(LogicType logic, ConditionCost cost,
+			      bool skippable)
+{
+	_entries.push_back({logic, cost, skippable});
+}
+
+// The root condition can be treated as if it was combined with the conditions
+// following it using the logic of the first non-root condition.
+// Returns LogicType::NONE if the first condition is not a root condition.
+LogicType ConditionLogicChain::GetRootCombineLogic()
+{
+	if (_entries.empty() || !isRootLogicType(_entries[0].logic)) {
+		return LogicType::NONE;
+	}
+	for (size_t i = 1; i < _entries.size(); i++) {
+		if (isAndLogic(_entries[i].logic)) {
+			return LogicType::AND;
+		}
+		if (isOrLogic(_entries[i].logic)) {
+			return LogicType::OR;
+		}
+	}
+	return LogicType::AND;
+}
+
+// Stable insertion sort, as runs are usually short and std::stable_sort would
+// allocate a temporary buffer each interval
+template<class It, class Compare>
+static void insertionSort(It begin, It end, Compare compare)
+{
+	for (auto it = begin; it != end; ++it) {
+		auto pos = std::upper_bound(begin, it, *it, compare);
+		std::rotate(pos, it, it + 1);
+	}
+}
+
+void ConditionLogicChain::SortByCost(LogicType rootLogic)
+{
+	auto getLogicClass = [this, rootLogic](size_t idx) {
+		auto logic = _entries[idx].logic;
+		if (isRootLogicType(logic)) {
+			return idx == 0 ? rootLogic : LogicType::ROOT_NONE;
+		}
+		if (isAndLogic(logic)) {
+			return LogicType::AND;
+		}
+		if (isOrLogic(logic)) {
+			return LogicType::OR;
+		}
+		return LogicType::NONE;
+	};
+
+	// Conditions which cannot be skipped have to be checked anyway and
+	// might make checking the remaining conditions unnecessary
+	auto compare = [this](size_t a, size_t b) {
+		const auto &entryA = _entries[a];
+		const auto &entryB = _entries[b];
+		if (entryA.skippable != entryB.skippable) {
+			return !entryA.skippable;
+		}
+		return entryA.cost < entryB.cost;
+	};
+
+	size_t runStart = 0;
+	LogicType runLogic = LogicType::NONE;
+	for (size_t i = 0; i < _order.size(); i++) {
+		auto logic = getLogicClass(i);
+		if (logic == LogicType::NONE) {
+			continue;
+		}
+		if (runLogic == LogicType::NONE) {
+			runLogic = logic;
+			continue;
+		}
+		if (logic != runLogic || logic == LogicType::ROOT_NONE) {
+			insertionSort(_order.begin() + runStart,
+				      _order.begin() + i, compare);
+			runStart = i;
+			runLogic = logic;
+		}
+	}
+	insertionSort(_order.begin() + runStart, _order.end(), compare);
+}
+
+bool ConditionLogicChain::Evaluate(bool shortCircuit, bool reorder,
+				   const std::function<bool(size_t)> &check,
+				   const std::function<void(size_t)> &skip)
+{
+	const auto rootLogic = GetRootCombineLogic();
+
+	_order.resize(_entries.size());
+	std::iota(_order.begin(), _order.end(), 0);
+	if (reorder) {
+		SortByCost(rootLogic);
+	}
+
+	// Start with the neutral element of the logic the root condition is
+	// combined with, as it might not be checked first
+	bool matched = rootLogic == LogicType::AND;
+
+	for (const auto idx : _order) {
+		const auto &entry = _entries[idx];
+		const bool isRoot = idx == 0 && rootLogic != LogicType::NONE;
+		const auto logic = isRoot ? rootLogic : entry.logic;
+
+		if (shortCircuit && entry.skippable &&
+		    !resultCanChange(logic, matched)) {
+			if (skip) {
+				skip(idx);
+			}
+			continue;
+		}
+
+		bool value = check(idx);
+		if (isRoot) {
+			if (entry.logic == LogicType::ROOT_NOT) {
+				value = !value;
+			}
+			matched = combine(rootLogic, matched, value);
+		} else {
+			matched = combine(entry.logic, matched, value);
+		}
+	}
+	return matched;
+}
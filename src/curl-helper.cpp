@@ -9,6 +9,16 @@ initFunction f_curl_init = nullptr;
 setOptFunction f_curl_setopt = nullptr;
 performFunction f_curl_perform = nullptr;
 cleanupFunction f_curl_cleanup = nullptr;
+getInfoFunction f_curl_getinfo = nullptr;
+slistAppendFunction f_curl_slist_append = nullptr;
+slistFreeAllFunction f_curl_slist_free_all = nullptr;
+multiInitFunction f_curl_multi_init = nullptr;
+multiAddHandleFunction f_curl_multi_add_handle = nullptr;
+multiRemoveHandleFunction f_curl_multi_remove_handle = nullptr;
+multiPerformFunction f_curl_multi_perform = nullptr;
+multiWaitFunction f_curl_multi_wait = nullptr;
+multiInfoReadFunction f_curl_multi_info_read = nullptr;
+multiCleanupFunction f_curl_multi_cleanup = nullptr;
 
 QLibrary *loaded_curl_lib = nullptr;
 
@@ -21,8 +31,36 @@ bool resolveCurl()
 		(performFunction)loaded_curl_lib->resolve("curl_easy_perform");
 	f_curl_cleanup =
 		(cleanupFunction)loaded_curl_lib->resolve("curl_easy_cleanup");
+	f_curl_getinfo =
+		(getInfoFunction)loaded_curl_lib->resolve("curl_easy_getinfo");
+	f_curl_slist_append = (slistAppendFunction)loaded_curl_lib->resolve(
+		"curl_slist_append");
+	f_curl_slist_free_all = (slistFreeAllFunction)loaded_curl_lib->resolve(
+		"curl_slist_free_all");
+	f_curl_multi_init =
+		(multiInitFunction)loaded_curl_lib->resolve("curl_multi_init");
+	f_curl_multi_add_handle =
+		(multiAddHandleFunction)loaded_curl_lib->resolve(
+			"curl_multi_add_handle");
+	f_curl_multi_remove_handle =
+		(multiRemoveHandleFunction)loaded_curl_lib->resolve(
+			"curl_multi_remove_handle");
+	f_curl_multi_perform = (multiPerformFunction)loaded_curl_lib->resolve(
+		"curl_multi_perform");
+	f_curl_multi_wait =
+		(multiWaitFunction)loaded_curl_lib->resolve("curl_multi_wait");
+	f_curl_multi_info_read =
+		(multiInfoReadFunction)loaded_curl_lib->resolve(
+			"curl_multi_info_read");
+	f_curl_multi_cleanup = (multiCleanupFunction)loaded_curl_lib->resolve(
+		"curl_multi_cleanup");
 
-	if (f_curl_init && f_curl_setopt && f_curl_perform && f_curl_cleanup) {
+	if (f_curl_init && f_curl_setopt && f_curl_perform && f_curl_cleanup &&
+	    f_curl_getinfo && f_curl_slist_append && f_curl_slist_free_all &&
+	    f_curl_multi_init && f_curl_multi_add_handle &&
+	    f_curl_multi_remove_handle && f_curl_multi_perform &&
+	    f_curl_multi_wait && f_curl_multi_info_read &&
+	    f_curl_multi_cleanup) {
 		blog(LOG_INFO, "[adv-ss] curl loaded successfully");
 		return true;
 	}
@@ -4,11 +4,16 @@
 #include <macro-condition-edit.hpp>
 #include <switcher-data-structs.hpp>
 #include <utility.hpp>
+#include <regex-cache.hpp>
 
 #include <QFileDialog>
 #include <QBuffer>
 #include <QToolTip>
 #include <QMessageBox>
+#include <QColorDialog>
+#include <QThread>
+#include <QThreadPool>
+#include <cmath>
 
 const std::string MacroConditionVideo::id = "video";
 
@@ -32,19 +37,32 @@ static std::map<VideoCondition, std::string> conditionTypes = {
 	 "AdvSceneSwitcher.condition.video.condition.pattern"},
 	{VideoCondition::OBJECT,
 	 "AdvSceneSwitcher.condition.video.condition.object"},
+#ifdef OCR_SUPPORT
+	{VideoCondition::TEXT, "AdvSceneSwitcher.condition.video.condition.text"},
+#endif
+	{VideoCondition::COLOR,
+	 "AdvSceneSwitcher.condition.video.condition.color"},
 };
 
-cv::CascadeClassifier initObjectCascade(std::string &path)
-{
-	cv::CascadeClassifier cascade;
-	try {
-		cascade.load(path);
-	} catch (...) {
-		blog(LOG_WARNING, "failed to load model data \"%s\"",
-		     path.c_str());
-	}
-	return cascade;
-}
+static std::map<ChangeDetection, std::string> changeDetectionTypes = {
+	{ChangeDetection::EXACT,
+	 "AdvSceneSwitcher.condition.video.changeDetection.exact"},
+	{ChangeDetection::PATTERN,
+	 "AdvSceneSwitcher.condition.video.changeDetection.pattern"},
+	{ChangeDetection::DIFFERENCE,
+	 "AdvSceneSwitcher.condition.video.changeDetection.difference"},
+	{ChangeDetection::HASH,
+	 "AdvSceneSwitcher.condition.video.changeDetection.hash"},
+};
+
+static std::map<PatternMatchMode, std::string> patternMatchModes = {
+	{PatternMatchMode::FULL,
+	 "AdvSceneSwitcher.condition.video.patternMatchMode.full"},
+	{PatternMatchMode::PYRAMID,
+	 "AdvSceneSwitcher.condition.video.patternMatchMode.pyramid"},
+	{PatternMatchMode::MULTI_SCALE,
+	 "AdvSceneSwitcher.condition.video.patternMatchMode.multiScale"},
+};
 
 bool requiresFileInput(VideoCondition t)
 {
@@ -52,51 +70,310 @@ bool requiresFileInput(VideoCondition t)
 	       t == VideoCondition::PATTERN;
 }
 
-bool MacroConditionVideo::CheckShouldBeSkipped()
+bool needsThrottleControls(VideoCondition cond)
+{
+	return cond == VideoCondition::PATTERN ||
+	       cond == VideoCondition::OBJECT || cond == VideoCondition::TEXT;
+}
+
+// Exact comparisons with an image file only make sense at full resolution
+static bool supportsCaptureScale(VideoCondition t)
+{
+	return t == VideoCondition::HAS_CHANGED ||
+	       t == VideoCondition::HAS_NOT_CHANGED ||
+	       t == VideoCondition::PATTERN || t == VideoCondition::OBJECT ||
+	       t == VideoCondition::COLOR;
+}
+
+// Results which are older than the time between two analyses plus this delay
+// indicate that the vision workers cannot keep up with the video checks or no
+// new frames are captured anymore
+constexpr auto maxResultDelay = std::chrono::seconds(1);
+
+// Video analysis is performed in its own thread pool so that expensive checks
+// never block the switcher thread or the macro thread pool
+static QThreadPool &getVisionThreadPool()
+{
+	static QThreadPool pool;
+	static std::once_flag once;
+	std::call_once(once, []() {
+		int threads = QThread::idealThreadCount() / 2;
+		pool.setMaxThreadCount(threads > 0 ? threads : 1);
+		// Keep the threads and their cached OCR engines alive
+		pool.setExpiryTimeout(-1);
+	});
+	return pool;
+}
+
+// A frame is only considered unchanged if it is similar to all frames in the
+// history, so slow gradual changes are detected as well
+static bool signatureChanged(const VideoAnalysisJob &job,
+			     FrameHistory &history)
+{
+	thread_local FrameSignature signature;
+	updateFrameSignature(job.screenshot, signature);
+
+	double difference = history.count == 0 ? 1. : 0.;
+	for (size_t i = 0; i < history.count; i++) {
+		const auto &previous = history.signatures[i];
+		double value =
+			job.changeDetection == ChangeDetection::HASH
+				? getHashDifference(signature, previous)
+				: getFrameDifference(signature, previous);
+		if (value > difference) {
+			difference = value;
+		}
+	}
+
+	// Swapping recycles the buffers of the oldest signature
+	std::swap(history.signatures[history.next], signature);
+	history.next = (history.next + 1) % history.signatures.size();
+	if (history.count < history.signatures.size()) {
+		history.count++;
+	}
+	return 1. - difference < job.patternThreshold;
+}
+
+static bool outputChanged(const VideoAnalysisJob &job, FrameHistory &history)
+{
+	if (job.changeDetection == ChangeDetection::DIFFERENCE ||
+	    job.changeDetection == ChangeDetection::HASH) {
+		return signatureChanged(job, history);
+	}
+	if (job.changeDetection == ChangeDetection::PATTERN) {
+		// Buffers are reused by consecutive jobs on the same worker
+		thread_local PatternMatchData patternData;
+		thread_local cv::Mat result;
+		updatePatternData(job.matchImage, patternData);
+		matchPattern(job.screenshot, patternData, job.patternThreshold,
+			     result, job.useAlphaAsMask);
+		return countNonZero(result) == 0;
+	}
+	return job.screenshot != job.matchImage;
+}
+
+static bool screenshotContainsPattern(const VideoAnalysisJob &job)
 {
-	if (_condition != VideoCondition::PATTERN &&
-	    _condition != VideoCondition::OBJECT) {
+	thread_local cv::Mat result;
+	if (job.patternMatchMode == PatternMatchMode::MULTI_SCALE) {
+		return matchPatternMultiScale(job.screenshot,
+					      job.scaledPatternData,
+					      job.patternThreshold, result,
+					      job.useAlphaAsMask) != 0.;
+	}
+	matchPattern(job.screenshot, job.patternData, job.patternThreshold,
+		     result, job.useAlphaAsMask,
+		     job.patternMatchMode == PatternMatchMode::PYRAMID);
+	return countNonZero(result) > 0;
+}
+
+static bool screenshotContainsObject(VideoAnalysisJob &job)
+{
+	if (!job.objectModel) {
 		return false;
 	}
+	auto objects = job.objectModel->Detect(job.screenshot,
+					       job.objectDetection);
+	return objects.size() > 0;
+}
 
-	if (_throttleEnabled) {
-		if (_runCount <= _throttleCount) {
-			_runCount++;
-			return true;
-		} else {
-			_runCount = 0;
-		}
+static bool screenshotContainsText(const VideoAnalysisJob &job)
+{
+#ifdef OCR_SUPPORT
+	auto text = QString::fromStdString(
+			    recognizeText(job.screenshot, job.ocrLanguage))
+			    .simplified();
+	if (job.useRegex) {
+		return getRegex(QString::fromStdString(job.text))
+			.match(text)
+			.hasMatch();
 	}
+	return text.contains(QString::fromStdString(job.text));
+#else
+	(void)job;
 	return false;
+#endif
 }
 
-bool MacroConditionVideo::CheckCondition()
+static bool screenshotMatchesColor(const VideoAnalysisJob &job)
 {
-	if (!_video.ValidSelection()) {
+	if (job.screenshot.isNull()) {
 		return false;
 	}
+	auto difference =
+		getColorDifference(getMeanColor(job.screenshot), job.color);
+	return 1. - difference >= job.patternThreshold;
+}
 
-	bool match = false;
-	if (CheckShouldBeSkipped()) {
-		return _lastMatchResult;
+// The check area is already applied when capturing the frame
+static bool compare(VideoAnalysisJob &job, FrameHistory &history)
+{
+	switch (job.condition) {
+	case VideoCondition::MATCH:
+		return job.screenshot == job.matchImage;
+	case VideoCondition::DIFFER:
+		return job.screenshot != job.matchImage;
+	case VideoCondition::HAS_CHANGED:
+		return outputChanged(job, history);
+	case VideoCondition::HAS_NOT_CHANGED:
+		return !outputChanged(job, history);
+	case VideoCondition::NO_IMAGE:
+		return job.screenshot.isNull();
+	case VideoCondition::PATTERN:
+		return screenshotContainsPattern(job);
+	case VideoCondition::OBJECT:
+		return screenshotContainsObject(job);
+	case VideoCondition::TEXT:
+		return screenshotContainsText(job);
+	case VideoCondition::COLOR:
+		return screenshotMatchesColor(job);
+	default:
+		break;
 	}
+	return false;
+}
 
-	if (_screenshotData.done) {
-		match = Compare();
-		_lastMatchResult = match;
+std::chrono::milliseconds MacroConditionVideo::GetAnalysisInterval()
+{
+	if (!_throttleEnabled || !needsThrottleControls(_condition)) {
+		return std::chrono::milliseconds(GetSwitcher()->interval);
+	}
+	// The throttle count is stored in multiples of the switcher interval
+	return std::chrono::milliseconds(_throttleCount *
+					 GetSwitcher()->interval);
+}
 
-		if (!requiresFileInput(_condition)) {
-			_matchImage = std::move(_screenshotData.image);
-		}
-		_getNextScreenshot = true;
-	} else {
-		match = _lastMatchResult;
+bool MacroConditionVideo::AnalysisDue()
+{
+	if (!_throttleEnabled || !needsThrottleControls(_condition)) {
+		return true;
 	}
+	return std::chrono::high_resolution_clock::now() - _lastAnalysis >=
+	       GetAnalysisInterval();
+}
 
-	if (_getNextScreenshot) {
+bool MacroConditionVideo::StartAnalysis(SourceCapture::Frame &frame)
+{
+	if (_analysis->running.exchange(true)) {
+		return false;
+	}
+	uint64_t generation;
+	{
+		std::lock_guard<std::mutex> lock(_analysis->mutex);
+		generation = _analysis->generation;
+	}
+
+	_lastFrame = frame.sequence;
+	_lastAnalysis = std::chrono::high_resolution_clock::now();
+
+	VideoAnalysisJob job;
+	job.condition = _condition;
+	job.frameTime = frame.time;
+	job.screenshot = std::move(frame.image);
+	job.matchImage = _matchImage;
+	job.changeDetection = _changeDetection;
+	job.patternData = _patternData;
+	job.scaledPatternData = _scaledPatternData;
+	job.patternMatchMode = _patternMatchMode;
+	job.patternThreshold = _patternThreshold;
+	job.useAlphaAsMask = _useAlphaAsMask;
+	job.objectModel = _objectModel;
+	job.objectDetection = GetObjectDetectionSettings(GetCaptureScale());
+	job.text = _text;
+	job.useRegex = _useRegex;
+	job.ocrLanguage = _ocrLanguage;
+	job.color = cv::Scalar(_color.red(), _color.green(), _color.blue());
+
+	if (!requiresFileInput(_condition)) {
+		_matchImage = job.screenshot;
+	}
+
+	auto analysis = _analysis;
+	getVisionThreadPool().start(Compatability::CreateFunctionRunnable(
+		[job, analysis, generation]() mutable {
+			if (analysis->historyGeneration != generation) {
+				analysis->history = {};
+				analysis->historyGeneration = generation;
+			}
+			bool match = compare(job, analysis->history);
+			std::lock_guard<std::mutex> lock(analysis->mutex);
+			analysis->running = false;
+			if (analysis->generation != generation) {
+				return;
+			}
+			analysis->valid = true;
+			analysis->match = match;
+			analysis->frameTime = job.frameTime;
+		}));
+	return true;
+}
+
+bool MacroConditionVideo::GetAnalysisResult()
+{
+	std::lock_guard<std::mutex> lock(_analysis->mutex);
+	if (!_analysis->valid) {
+		return false;
+	}
+
+	auto age = std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::high_resolution_clock::now() -
+		_analysis->frameTime);
+	// Outdated results no longer describe the video, so they never match
+	bool stale = age > GetAnalysisInterval() + maxResultDelay;
+	if (stale && !_staleResultLogged) {
+		vblog(LOG_INFO,
+		      "ignoring video analysis result which is %lld ms old",
+		      (long long)age.count());
+	}
+	_staleResultLogged = stale;
+	return !stale && _analysis->match;
+}
+
+// The object sizes have to be scaled the same way as the analyzed frames
+ObjectDetectionSettings
+MacroConditionVideo::GetObjectDetectionSettings(double scale)
+{
+	ObjectDetectionSettings settings;
+	settings.scaleFactor = _scaleFactor;
+	settings.minNeighbors = _minNeighbors;
+	settings.minSize = cv::Size(std::lround(_minSize.width * scale),
+				    std::lround(_minSize.height * scale));
+	settings.maxSize = cv::Size(std::lround(_maxSize.width * scale),
+				    std::lround(_maxSize.height * scale));
+	settings.confidence = _dnnConfidence;
+	settings.classId = _dnnClassId;
+	settings.inputSize = _dnnInputSize;
+	return settings;
+}
+
+bool MacroConditionVideo::UsesNeuralNetwork()
+{
+	return ObjectModel::IsNeuralNetwork(_modelDataPath);
+}
+
+void MacroConditionVideo::ResetLastMatch()
+{
+	std::lock_guard<std::mutex> lock(_analysis->mutex);
+	_analysis->valid = false;
+	_analysis->generation++;
+	_lastFrame = 0;
+}
+
+bool MacroConditionVideo::CheckCondition()
+{
+	if (!_video.ValidSelection()) {
+		return false;
+	}
+
+	// Only request new frames if they can actually be analyzed
+	if (AnalysisDue() && !_analysis->running) {
 		GetScreenshot();
+		auto frame = _capture->GetFrame();
+		if (frame.sequence != _lastFrame) {
+			StartAnalysis(frame);
+		}
 	}
-	return match;
+	return GetAnalysisResult();
 }
 
 bool MacroConditionVideo::Save(obs_data_t *obj)
@@ -105,19 +382,30 @@ bool MacroConditionVideo::Save(obs_data_t *obj)
 	_video.Save(obj);
 	obs_data_set_int(obj, "condition", static_cast<int>(_condition));
 	obs_data_set_string(obj, "filePath", _file.c_str());
-	obs_data_set_bool(obj, "usePatternForChangedCheck",
-			  _usePatternForChangedCheck);
+	obs_data_set_int(obj, "changeDetection",
+			 static_cast<int>(_changeDetection));
 	obs_data_set_double(obj, "threshold", _patternThreshold);
 	obs_data_set_bool(obj, "useAlphaAsMask", _useAlphaAsMask);
+	obs_data_set_int(obj, "patternMatchMode",
+			 static_cast<int>(_patternMatchMode));
 	obs_data_set_string(obj, "modelDataPath", _modelDataPath.c_str());
 	obs_data_set_double(obj, "scaleFactor", _scaleFactor);
 	obs_data_set_int(obj, "minNeighbors", _minNeighbors);
 	_minSize.Save(obj, "minSize");
 	_maxSize.Save(obj, "maxSize");
+	obs_data_set_double(obj, "dnnConfidence", _dnnConfidence);
+	obs_data_set_int(obj, "dnnClassId", _dnnClassId);
+	obs_data_set_int(obj, "dnnInputSize", _dnnInputSize);
+	obs_data_set_string(obj, "text", _text.c_str());
+	obs_data_set_bool(obj, "useRegex", _useRegex);
+	obs_data_set_string(obj, "ocrLanguage", _ocrLanguage.c_str());
+	obs_data_set_string(obj, "color",
+			    _color.name().toStdString().c_str());
 	obs_data_set_bool(obj, "throttleEnabled", _throttleEnabled);
 	obs_data_set_int(obj, "throttleCount", _throttleCount);
 	obs_data_set_bool(obj, "checkAreaEnabled", _checkAreaEnable);
 	_checkArea.Save(obj, "checkArea");
+	obs_data_set_double(obj, "captureScale", _captureScale);
 	return true;
 }
 
@@ -142,10 +430,19 @@ bool MacroConditionVideo::Load(obs_data_t *obj)
 	_condition =
 		static_cast<VideoCondition>(obs_data_get_int(obj, "condition"));
 	_file = obs_data_get_string(obj, "filePath");
-	_usePatternForChangedCheck =
-		obs_data_get_bool(obj, "usePatternForChangedCheck");
+	if (obs_data_has_user_value(obj, "changeDetection")) {
+		_changeDetection = static_cast<ChangeDetection>(
+			obs_data_get_int(obj, "changeDetection"));
+	} else {
+		_changeDetection =
+			obs_data_get_bool(obj, "usePatternForChangedCheck")
+				? ChangeDetection::PATTERN
+				: ChangeDetection::EXACT;
+	}
 	_patternThreshold = obs_data_get_double(obj, "threshold");
 	_useAlphaAsMask = obs_data_get_bool(obj, "useAlphaAsMask");
+	_patternMatchMode = static_cast<PatternMatchMode>(
+		obs_data_get_int(obj, "patternMatchMode"));
 	_modelDataPath = obs_data_get_string(obj, "modelDataPath");
 	_scaleFactor = obs_data_get_double(obj, "scaleFactor");
 	if (!isScaleFactorValid(_scaleFactor)) {
@@ -165,16 +462,34 @@ bool MacroConditionVideo::Load(obs_data_t *obj)
 		_minSize.Load(obj, "minSize");
 		_maxSize.Load(obj, "maxSize");
 	}
+	obs_data_set_default_double(obj, "dnnConfidence", 0.5);
+	_dnnConfidence = obs_data_get_double(obj, "dnnConfidence");
+	obs_data_set_default_int(obj, "dnnClassId", -1);
+	_dnnClassId = obs_data_get_int(obj, "dnnClassId");
+	obs_data_set_default_int(obj, "dnnInputSize", 320);
+	_dnnInputSize = obs_data_get_int(obj, "dnnInputSize");
+	_text = obs_data_get_string(obj, "text");
+	_useRegex = obs_data_get_bool(obj, "useRegex");
+	obs_data_set_default_string(obj, "ocrLanguage", "eng");
+	_ocrLanguage = obs_data_get_string(obj, "ocrLanguage");
+	obs_data_set_default_string(obj, "color", "#000000");
+	_color = QColor(obs_data_get_string(obj, "color"));
 	_throttleEnabled = obs_data_get_bool(obj, "throttleEnabled");
 	_throttleCount = obs_data_get_int(obj, "throttleCount");
 	_checkAreaEnable = obs_data_get_bool(obj, "checkAreaEnabled");
 	_checkArea.Load(obj, "checkArea");
+	obs_data_set_default_double(obj, "captureScale", 1.);
+	_captureScale = obs_data_get_double(obj, "captureScale");
+	if (_captureScale <= 0. || _captureScale > 1.) {
+		_captureScale = 1.;
+	}
 	if (requiresFileInput(_condition)) {
 		(void)LoadImageFromFile();
 	}
 
+	// The model data is only parsed once it is needed
 	if (_condition == VideoCondition::OBJECT) {
-		LoadModelData(_modelDataPath);
+		_objectModel = ObjectModel::Get(_modelDataPath);
 	}
 
 	return true;
@@ -185,13 +500,34 @@ std::string MacroConditionVideo::GetShortDesc()
 	return _video.ToString();
 }
 
+double MacroConditionVideo::GetCaptureScale()
+{
+	return supportsCaptureScale(_condition) ? _captureScale : 1.;
+}
+
+CaptureSettings MacroConditionVideo::GetCaptureSettings()
+{
+	CaptureSettings settings;
+	if (_checkAreaEnable && _condition != VideoCondition::NO_IMAGE) {
+		settings.x = _checkArea.x;
+		settings.y = _checkArea.y;
+		settings.width = _checkArea.width;
+		settings.height = _checkArea.height;
+	}
+	settings.scale = GetCaptureScale();
+	return settings;
+}
+
 void MacroConditionVideo::GetScreenshot()
 {
-	auto source = obs_weak_source_get_source(_video.GetVideo());
-	_screenshotData.~ScreenshotHelper();
-	new (&_screenshotData) ScreenshotHelper(source);
-	obs_source_release(source);
-	_getNextScreenshot = false;
+	auto source = _video.GetVideo();
+	auto settings = GetCaptureSettings();
+	if (!_capture || _capture->GetSource() != source ||
+	    _capture->GetSettings() != settings) {
+		_capture = SourceCapture::Get(source, settings);
+		_lastFrame = 0;
+	}
+	_capture->Request();
 }
 
 bool MacroConditionVideo::LoadImageFromFile()
@@ -204,77 +540,56 @@ bool MacroConditionVideo::LoadImageFromFile()
 
 	_matchImage =
 		_matchImage.convertToFormat(QImage::Format::Format_RGBA8888);
-	_patternData = createPatternData(_matchImage);
+
+	// The pattern has to be scaled the same way as the captured frames
+	QImage pattern = _matchImage;
+	auto scale = GetCaptureScale();
+	if (_condition == VideoCondition::PATTERN && scale != 1.) {
+		pattern = _matchImage.scaled(
+			std::lround(_matchImage.width() * scale),
+			std::lround(_matchImage.height() * scale),
+			Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+	}
+
+	// New buffers are allocated instead of updating the existing ones, as
+	// those might still be in use by a running analysis job
+	_patternData = createPatternData(pattern);
+	std::vector<ScaledPatternData> scaledPatternData;
+	if (_condition == VideoCondition::PATTERN &&
+	    _patternMatchMode == PatternMatchMode::MULTI_SCALE) {
+		updateScaledPatternData(pattern, scaledPatternData);
+	}
+	_scaledPatternData = std::move(scaledPatternData);
 	return true;
 }
 
 bool MacroConditionVideo::LoadModelData(std::string &path)
 {
 	_modelDataPath = path;
-	_objectCascade = initObjectCascade(path);
-	return !_objectCascade.empty();
-}
-
-bool MacroConditionVideo::ScreenshotContainsPattern()
-{
-	cv::Mat result;
-	matchPattern(_screenshotData.image, _patternData, _patternThreshold,
-		     result, _useAlphaAsMask);
-	return countNonZero(result) > 0;
+	_objectModel = ObjectModel::Get(path);
+	return _objectModel->Load();
 }
 
-bool MacroConditionVideo::OutputChanged()
+static inline void populateConditionSelection(QComboBox *list)
 {
-	if (_usePatternForChangedCheck) {
-		cv::Mat result;
-		_patternData = createPatternData(_matchImage);
-		matchPattern(_screenshotData.image, _patternData,
-			     _patternThreshold, result, _useAlphaAsMask);
-		return countNonZero(result) == 0;
+	// Not all condition types are available in every build, so the index
+	// does not necessarily match the condition type
+	for (auto entry : conditionTypes) {
+		list->addItem(obs_module_text(entry.second.c_str()),
+			      static_cast<int>(entry.first));
 	}
-	return _screenshotData.image != _matchImage;
-}
-
-bool MacroConditionVideo::ScreenshotContainsObject()
-{
-	auto objects = matchObject(_screenshotData.image, _objectCascade,
-				   _scaleFactor, _minNeighbors, _minSize.CV(),
-				   _maxSize.CV());
-	return objects.size() > 0;
 }
 
-bool MacroConditionVideo::Compare()
+static inline void populateChangeDetectionSelection(QComboBox *list)
 {
-	if (_checkAreaEnable && _condition != VideoCondition::NO_IMAGE) {
-		_screenshotData.image = _screenshotData.image.copy(
-			_checkArea.x, _checkArea.y, _checkArea.width,
-			_checkArea.height);
-	}
-
-	switch (_condition) {
-	case VideoCondition::MATCH:
-		return _screenshotData.image == _matchImage;
-	case VideoCondition::DIFFER:
-		return _screenshotData.image != _matchImage;
-	case VideoCondition::HAS_CHANGED:
-		return OutputChanged();
-	case VideoCondition::HAS_NOT_CHANGED:
-		return !OutputChanged();
-	case VideoCondition::NO_IMAGE:
-		return _screenshotData.image.isNull();
-	case VideoCondition::PATTERN:
-		return ScreenshotContainsPattern();
-	case VideoCondition::OBJECT:
-		return ScreenshotContainsObject();
-	default:
-		break;
+	for (auto entry : changeDetectionTypes) {
+		list->addItem(obs_module_text(entry.second.c_str()));
 	}
-	return false;
 }
 
-static inline void populateConditionSelection(QComboBox *list)
+static inline void populatePatternMatchModeSelection(QComboBox *list)
 {
-	for (auto entry : conditionTypes) {
+	for (auto entry : patternMatchModes) {
 		list->addItem(obs_module_text(entry.second.c_str()));
 	}
 }
@@ -284,8 +599,8 @@ MacroConditionVideoEdit::MacroConditionVideoEdit(
 	: QWidget(parent),
 	  _videoSelection(new VideoSelectionWidget(this)),
 	  _condition(new QComboBox()),
-	  _usePatternForChangedCheck(new QCheckBox(obs_module_text(
-		  "AdvSceneSwitcher.condition.video.usePatternForChangedCheck"))),
+	  _changeDetectionLayout(new QHBoxLayout),
+	  _changeDetection(new QComboBox()),
 	  _imagePath(new FileSelection()),
 	  _patternThreshold(new ThresholdSlider(
 		  0., 1.,
@@ -295,6 +610,8 @@ MacroConditionVideoEdit::MacroConditionVideoEdit(
 			  "AdvSceneSwitcher.condition.video.patternThresholdDescription"))),
 	  _useAlphaAsMask(new QCheckBox(obs_module_text(
 		  "AdvSceneSwitcher.condition.video.patternThresholdUseAlphaAsMask"))),
+	  _patternMatchModeLayout(new QHBoxLayout),
+	  _patternMatchMode(new QComboBox()),
 	  _modelDataPath(new FileSelection()),
 	  _modelPathLayout(new QHBoxLayout),
 	  _objectScaleThreshold(new ThresholdSlider(
@@ -310,6 +627,24 @@ MacroConditionVideoEdit::MacroConditionVideoEdit(
 	  _sizeLayout(new QHBoxLayout()),
 	  _minSize(new SizeSelection(0, 1024)),
 	  _maxSize(new SizeSelection(0, 4096)),
+	  _dnnConfidence(new ThresholdSlider(
+		  0., 1.,
+		  obs_module_text(
+			  "AdvSceneSwitcher.condition.video.dnnConfidence"),
+		  obs_module_text(
+			  "AdvSceneSwitcher.condition.video.dnnConfidenceDescription"))),
+	  _dnnControlLayout(new QHBoxLayout),
+	  _dnnClassId(new QSpinBox()),
+	  _dnnInputSize(new QSpinBox()),
+	  _textLayout(new QHBoxLayout),
+	  _text(new QLineEdit()),
+	  _useRegex(new QCheckBox(obs_module_text(
+		  "AdvSceneSwitcher.condition.video.useRegex"))),
+	  _ocrLanguage(new QLineEdit()),
+	  _colorLayout(new QHBoxLayout),
+	  _colorPreview(new QLabel()),
+	  _selectColor(new QPushButton(obs_module_text(
+		  "AdvSceneSwitcher.condition.video.selectColor"))),
 	  _checkAreaControlLayout(new QHBoxLayout),
 	  _checkAreaEnable(new QCheckBox()),
 	  _checkArea(new AreaSelection(0, 99999)),
@@ -318,18 +653,41 @@ MacroConditionVideoEdit::MacroConditionVideoEdit(
 	  _throttleControlLayout(new QHBoxLayout),
 	  _throttleEnable(new QCheckBox()),
 	  _throttleCount(new QSpinBox()),
+	  _captureScaleLayout(new QHBoxLayout),
+	  _captureScale(new QComboBox()),
 	  _showMatch(new QPushButton(obs_module_text(
 		  "AdvSceneSwitcher.condition.video.showMatch"))),
 	  _previewDialog(this, entryData.get(), &GetSwitcher()->m)
 {
 	_imagePath->Button()->disconnect();
-	_usePatternForChangedCheck->setToolTip(obs_module_text(
-		"AdvSceneSwitcher.condition.video.usePatternForChangedCheck.tooltip"));
+	populateChangeDetectionSelection(_changeDetection);
+	_changeDetection->setToolTip(obs_module_text(
+		"AdvSceneSwitcher.condition.video.changeDetection.tooltip"));
 	_minNeighbors->setMinimum(minMinNeighbors);
 	_minNeighbors->setMaximum(maxMinNeighbors);
+	_dnnClassId->setMinimum(-1);
+	_dnnClassId->setMaximum(9999);
+	_dnnClassId->setSpecialValueText(obs_module_text(
+		"AdvSceneSwitcher.condition.video.dnnClassId.any"));
+	_dnnInputSize->setMinimum(32);
+	_dnnInputSize->setMaximum(1280);
+	_dnnInputSize->setSingleStep(32);
+	_dnnInputSize->setSuffix("px");
+	_ocrLanguage->setToolTip(obs_module_text(
+		"AdvSceneSwitcher.condition.video.ocrLanguage.tooltip"));
+	_colorPreview->setFixedSize(24, 24);
 	_throttleCount->setMinimum(1 * GetSwitcher()->interval);
 	_throttleCount->setMaximum(10 * GetSwitcher()->interval);
 	_throttleCount->setSingleStep(GetSwitcher()->interval);
+	for (double scale : {1., 0.5, 0.25, 0.125}) {
+		_captureScale->addItem(QString::number(scale * 100.) + "%",
+				       scale);
+	}
+	_captureScale->setToolTip(obs_module_text(
+		"AdvSceneSwitcher.condition.video.captureScale.tooltip"));
+	populatePatternMatchModeSelection(_patternMatchMode);
+	_patternMatchMode->setToolTip(obs_module_text(
+		"AdvSceneSwitcher.condition.video.patternMatchMode.tooltip"));
 
 	QWidget::connect(_videoSelection,
 			 SIGNAL(VideoSelectionChange(const VideoSelection &)),
@@ -341,12 +699,14 @@ MacroConditionVideoEdit::MacroConditionVideoEdit(
 			 SLOT(ImagePathChanged(const QString &)));
 	QWidget::connect(_imagePath->Button(), SIGNAL(clicked()), this,
 			 SLOT(ImageBrowseButtonClicked()));
-	QWidget::connect(_usePatternForChangedCheck, SIGNAL(stateChanged(int)),
-			 this, SLOT(UsePatternForChangedCheckChanged(int)));
+	QWidget::connect(_changeDetection, SIGNAL(currentIndexChanged(int)),
+			 this, SLOT(ChangeDetectionChanged(int)));
 	QWidget::connect(_patternThreshold, SIGNAL(DoubleValueChanged(double)),
 			 this, SLOT(PatternThresholdChanged(double)));
 	QWidget::connect(_useAlphaAsMask, SIGNAL(stateChanged(int)), this,
 			 SLOT(UseAlphaAsMaskChanged(int)));
+	QWidget::connect(_patternMatchMode, SIGNAL(currentIndexChanged(int)),
+			 this, SLOT(PatternMatchModeChanged(int)));
 	QWidget::connect(_objectScaleThreshold,
 			 SIGNAL(DoubleValueChanged(double)), this,
 			 SLOT(ObjectScaleThresholdChanged(double)));
@@ -356,6 +716,20 @@ MacroConditionVideoEdit::MacroConditionVideoEdit(
 			 SLOT(MinSizeChanged(advss::Size)));
 	QWidget::connect(_maxSize, SIGNAL(SizeChanged(advss::Size)), this,
 			 SLOT(MaxSizeChanged(advss::Size)));
+	QWidget::connect(_dnnConfidence, SIGNAL(DoubleValueChanged(double)),
+			 this, SLOT(DNNConfidenceChanged(double)));
+	QWidget::connect(_dnnClassId, SIGNAL(valueChanged(int)), this,
+			 SLOT(DNNClassIdChanged(int)));
+	QWidget::connect(_dnnInputSize, SIGNAL(valueChanged(int)), this,
+			 SLOT(DNNInputSizeChanged(int)));
+	QWidget::connect(_text, SIGNAL(editingFinished()), this,
+			 SLOT(TextChanged()));
+	QWidget::connect(_useRegex, SIGNAL(stateChanged(int)), this,
+			 SLOT(UseRegexChanged(int)));
+	QWidget::connect(_ocrLanguage, SIGNAL(editingFinished()), this,
+			 SLOT(OCRLanguageChanged()));
+	QWidget::connect(_selectColor, SIGNAL(clicked()), this,
+			 SLOT(SelectColorClicked()));
 	QWidget::connect(_checkAreaEnable, SIGNAL(stateChanged(int)), this,
 			 SLOT(CheckAreaEnableChanged(int)));
 	QWidget::connect(_checkArea, SIGNAL(AreaChanged(advss::Area)), this,
@@ -366,6 +740,8 @@ MacroConditionVideoEdit::MacroConditionVideoEdit(
 			 SLOT(ThrottleEnableChanged(int)));
 	QWidget::connect(_throttleCount, SIGNAL(valueChanged(int)), this,
 			 SLOT(ThrottleCountChanged(int)));
+	QWidget::connect(_captureScale, SIGNAL(currentIndexChanged(int)), this,
+			 SLOT(CaptureScaleChanged(int)));
 	QWidget::connect(_showMatch, SIGNAL(clicked()), this,
 			 SLOT(ShowMatchClicked()));
 	QWidget::connect(&_previewDialog, SIGNAL(SelectionAreaChanged(QRect)),
@@ -389,6 +765,16 @@ MacroConditionVideoEdit::MacroConditionVideoEdit(
 		{"{{checkAreaEnable}}", _checkAreaEnable},
 		{"{{checkArea}}", _checkArea},
 		{"{{selectArea}}", _selectArea},
+		{"{{captureScale}}", _captureScale},
+		{"{{patternMatchMode}}", _patternMatchMode},
+		{"{{changeDetection}}", _changeDetection},
+		{"{{dnnClassId}}", _dnnClassId},
+		{"{{dnnInputSize}}", _dnnInputSize},
+		{"{{text}}", _text},
+		{"{{useRegex}}", _useRegex},
+		{"{{ocrLanguage}}", _ocrLanguage},
+		{"{{colorPreview}}", _colorPreview},
+		{"{{selectColor}}", _selectColor},
 	};
 	placeWidgets(obs_module_text("AdvSceneSwitcher.condition.video.entry"),
 		     entryLine1Layout, widgetPlaceholders);
@@ -400,6 +786,15 @@ MacroConditionVideoEdit::MacroConditionVideoEdit(
 		obs_module_text(
 			"AdvSceneSwitcher.condition.video.entry.minNeighbor"),
 		_neighborsControlLayout, widgetPlaceholders);
+	placeWidgets(
+		obs_module_text("AdvSceneSwitcher.condition.video.entry.dnn"),
+		_dnnControlLayout, widgetPlaceholders);
+	placeWidgets(
+		obs_module_text("AdvSceneSwitcher.condition.video.entry.text"),
+		_textLayout, widgetPlaceholders);
+	placeWidgets(
+		obs_module_text("AdvSceneSwitcher.condition.video.entry.color"),
+		_colorLayout, widgetPlaceholders);
 	placeWidgets(obs_module_text(
 			     "AdvSceneSwitcher.condition.video.entry.throttle"),
 		     _throttleControlLayout, widgetPlaceholders);
@@ -407,6 +802,18 @@ MacroConditionVideoEdit::MacroConditionVideoEdit(
 		obs_module_text(
 			"AdvSceneSwitcher.condition.video.entry.checkArea"),
 		_checkAreaControlLayout, widgetPlaceholders);
+	placeWidgets(
+		obs_module_text(
+			"AdvSceneSwitcher.condition.video.entry.captureScale"),
+		_captureScaleLayout, widgetPlaceholders);
+	placeWidgets(
+		obs_module_text(
+			"AdvSceneSwitcher.condition.video.entry.patternMatchMode"),
+		_patternMatchModeLayout, widgetPlaceholders);
+	placeWidgets(
+		obs_module_text(
+			"AdvSceneSwitcher.condition.video.entry.changeDetection"),
+		_changeDetectionLayout, widgetPlaceholders);
 
 	QGridLayout *sizeGrid = new QGridLayout;
 	sizeGrid->addWidget(
@@ -428,17 +835,23 @@ MacroConditionVideoEdit::MacroConditionVideoEdit(
 	showMatchLayout->addStretch();
 	QVBoxLayout *mainLayout = new QVBoxLayout;
 	mainLayout->addLayout(entryLine1Layout);
-	mainLayout->addWidget(_usePatternForChangedCheck);
+	mainLayout->addLayout(_changeDetectionLayout);
 	mainLayout->addWidget(_patternThreshold);
 	mainLayout->addWidget(_useAlphaAsMask);
+	mainLayout->addLayout(_patternMatchModeLayout);
 	mainLayout->addLayout(_modelPathLayout);
 	mainLayout->addWidget(_objectScaleThreshold);
 	mainLayout->addLayout(_neighborsControlLayout);
 	mainLayout->addWidget(_minNeighborsDescription);
+	mainLayout->addWidget(_dnnConfidence);
+	mainLayout->addLayout(_dnnControlLayout);
+	mainLayout->addLayout(_textLayout);
+	mainLayout->addLayout(_colorLayout);
 	mainLayout->addLayout(_sizeLayout);
 	mainLayout->addLayout(showMatchLayout);
 	mainLayout->addLayout(_throttleControlLayout);
 	mainLayout->addLayout(_checkAreaControlLayout);
+	mainLayout->addLayout(_captureScaleLayout);
 	setLayout(mainLayout);
 
 	_entryData = entryData;
@@ -485,14 +898,15 @@ void MacroConditionVideoEdit::VideoSelectionChanged(const VideoSelection &v)
 		QString::fromStdString(_entryData->GetShortDesc()));
 }
 
-void MacroConditionVideoEdit::ConditionChanged(int cond)
+void MacroConditionVideoEdit::ConditionChanged(int index)
 {
 	if (_loading || !_entryData) {
 		return;
 	}
 
 	std::lock_guard<std::mutex> lock(GetSwitcher()->m);
-	_entryData->_condition = static_cast<VideoCondition>(cond);
+	_entryData->_condition = static_cast<VideoCondition>(
+		_condition->itemData(index).toInt());
 	_entryData->ResetLastMatch();
 	SetWidgetVisibility();
 
@@ -507,7 +921,7 @@ void MacroConditionVideoEdit::ConditionChanged(int cond)
 
 	if (_entryData->_condition == VideoCondition::OBJECT) {
 		auto path = _entryData->GetModelDataPath();
-		_entryData->_objectCascade = initObjectCascade(path);
+		_entryData->LoadModelData(path);
 	}
 }
 
@@ -595,16 +1009,16 @@ void MacroConditionVideoEdit::ImageBrowseButtonClicked()
 	ImagePathChanged(path);
 }
 
-void MacroConditionVideoEdit::UsePatternForChangedCheckChanged(int value)
+void MacroConditionVideoEdit::ChangeDetectionChanged(int index)
 {
 	if (_loading || !_entryData) {
 		return;
 	}
 
 	std::lock_guard<std::mutex> lock(GetSwitcher()->m);
-	_entryData->_usePatternForChangedCheck = value;
-	_patternThreshold->setVisible(value);
-	adjustSize();
+	_entryData->_changeDetection = static_cast<ChangeDetection>(index);
+	_entryData->ResetLastMatch();
+	SetWidgetVisibility();
 }
 
 void MacroConditionVideoEdit::PatternThresholdChanged(double value)
@@ -628,6 +1042,17 @@ void MacroConditionVideoEdit::UseAlphaAsMaskChanged(int value)
 	_entryData->LoadImageFromFile();
 }
 
+void MacroConditionVideoEdit::PatternMatchModeChanged(int index)
+{
+	if (_loading || !_entryData) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(GetSwitcher()->m);
+	_entryData->_patternMatchMode = static_cast<PatternMatchMode>(index);
+	_entryData->LoadImageFromFile();
+}
+
 void MacroConditionVideoEdit::ObjectScaleThresholdChanged(double value)
 {
 	if (_loading || !_entryData) {
@@ -668,6 +1093,91 @@ void MacroConditionVideoEdit::MaxSizeChanged(advss::Size value)
 	_entryData->_maxSize = value;
 }
 
+void MacroConditionVideoEdit::DNNConfidenceChanged(double value)
+{
+	if (_loading || !_entryData) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(GetSwitcher()->m);
+	_entryData->_dnnConfidence = value;
+}
+
+void MacroConditionVideoEdit::DNNClassIdChanged(int value)
+{
+	if (_loading || !_entryData) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(GetSwitcher()->m);
+	_entryData->_dnnClassId = value;
+}
+
+void MacroConditionVideoEdit::DNNInputSizeChanged(int value)
+{
+	if (_loading || !_entryData) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(GetSwitcher()->m);
+	_entryData->_dnnInputSize = value;
+}
+
+void MacroConditionVideoEdit::TextChanged()
+{
+	if (_loading || !_entryData) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(GetSwitcher()->m);
+	_entryData->_text = _text->text().toStdString();
+}
+
+void MacroConditionVideoEdit::UseRegexChanged(int value)
+{
+	if (_loading || !_entryData) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(GetSwitcher()->m);
+	_entryData->_useRegex = value;
+}
+
+void MacroConditionVideoEdit::OCRLanguageChanged()
+{
+	if (_loading || !_entryData) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(GetSwitcher()->m);
+	_entryData->_ocrLanguage = _ocrLanguage->text().toStdString();
+}
+
+void MacroConditionVideoEdit::SelectColorClicked()
+{
+	if (_loading || !_entryData) {
+		return;
+	}
+
+	auto color = QColorDialog::getColor(_entryData->_color, this);
+	if (!color.isValid()) {
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(GetSwitcher()->m);
+		_entryData->_color = color;
+	}
+	UpdateColorPreview();
+}
+
+void MacroConditionVideoEdit::UpdateColorPreview()
+{
+	_colorPreview->setStyleSheet("background-color: " +
+				     _entryData->_color.name() + ";");
+	_colorPreview->setToolTip(_entryData->_color.name());
+}
+
 void MacroConditionVideoEdit::CheckAreaEnableChanged(int value)
 {
 	if (_loading || !_entryData) {
@@ -718,6 +1228,20 @@ void MacroConditionVideoEdit::ThrottleCountChanged(int value)
 	_entryData->_throttleCount = value / GetSwitcher()->interval;
 }
 
+void MacroConditionVideoEdit::CaptureScaleChanged(int index)
+{
+	if (_loading || !_entryData) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(GetSwitcher()->m);
+	_entryData->_captureScale = _captureScale->itemData(index).toDouble();
+	_entryData->ResetLastMatch();
+	if (requiresFileInput(_entryData->_condition)) {
+		_entryData->LoadImageFromFile();
+	}
+}
+
 void MacroConditionVideoEdit::ShowMatchClicked()
 {
 	_previewDialog.show();
@@ -746,6 +1270,7 @@ void MacroConditionVideoEdit::ModelPathChanged(const QString &text)
 		std::string path = text.toStdString();
 		dataLoaded = _entryData->LoadModelData(path);
 	}
+	SetWidgetVisibility();
 	if (!dataLoaded) {
 		DisplayMessage(obs_module_text(
 			"AdvSceneSwitcher.condition.video.modelLoadFail"));
@@ -755,7 +1280,8 @@ void MacroConditionVideoEdit::ModelPathChanged(const QString &text)
 bool needsShowMatch(VideoCondition cond)
 {
 	return cond == VideoCondition::PATTERN ||
-	       cond == VideoCondition::OBJECT;
+	       cond == VideoCondition::OBJECT ||
+	       cond == VideoCondition::TEXT || cond == VideoCondition::COLOR;
 }
 
 bool needsObjectControls(VideoCondition cond)
@@ -763,15 +1289,10 @@ bool needsObjectControls(VideoCondition cond)
 	return cond == VideoCondition::OBJECT;
 }
 
-bool needsThrottleControls(VideoCondition cond)
-{
-	return cond == VideoCondition::PATTERN ||
-	       cond == VideoCondition::OBJECT;
-}
-
 bool needsThreshold(VideoCondition cond)
 {
 	return cond == VideoCondition::PATTERN ||
+	       cond == VideoCondition::COLOR ||
 	       cond == VideoCondition::HAS_CHANGED ||
 	       cond == VideoCondition::HAS_NOT_CHANGED;
 }
@@ -790,18 +1311,28 @@ bool needsAreaControls(VideoCondition cond)
 void MacroConditionVideoEdit::SetWidgetVisibility()
 {
 	_imagePath->setVisible(requiresFileInput(_entryData->_condition));
-	_usePatternForChangedCheck->setVisible(
-		patternControlIsOptional(_entryData->_condition));
+	setLayoutVisible(_changeDetectionLayout,
+			 patternControlIsOptional(_entryData->_condition));
 	_patternThreshold->setVisible(needsThreshold(_entryData->_condition));
 	_useAlphaAsMask->setVisible(_entryData->_condition ==
 				    VideoCondition::PATTERN);
+	setLayoutVisible(_patternMatchModeLayout,
+			 _entryData->_condition == VideoCondition::PATTERN);
 	_showMatch->setVisible(needsShowMatch(_entryData->_condition));
-	_objectScaleThreshold->setVisible(
-		needsObjectControls(_entryData->_condition));
-	setLayoutVisible(_neighborsControlLayout,
-			 needsObjectControls(_entryData->_condition));
-	_minNeighborsDescription->setVisible(
-		needsObjectControls(_entryData->_condition));
+	const bool cascadeControls =
+		needsObjectControls(_entryData->_condition) &&
+		!_entryData->UsesNeuralNetwork();
+	const bool dnnControls = needsObjectControls(_entryData->_condition) &&
+				 _entryData->UsesNeuralNetwork();
+	_objectScaleThreshold->setVisible(cascadeControls);
+	setLayoutVisible(_neighborsControlLayout, cascadeControls);
+	_minNeighborsDescription->setVisible(cascadeControls);
+	_dnnConfidence->setVisible(dnnControls);
+	setLayoutVisible(_dnnControlLayout, dnnControls);
+	setLayoutVisible(_textLayout,
+			 _entryData->_condition == VideoCondition::TEXT);
+	setLayoutVisible(_colorLayout,
+			 _entryData->_condition == VideoCondition::COLOR);
 	setLayoutVisible(_sizeLayout,
 			 needsObjectControls(_entryData->_condition));
 	setLayoutVisible(_modelPathLayout,
@@ -810,11 +1341,13 @@ void MacroConditionVideoEdit::SetWidgetVisibility()
 			 needsThrottleControls(_entryData->_condition));
 	setLayoutVisible(_checkAreaControlLayout,
 			 needsAreaControls(_entryData->_condition));
+	setLayoutVisible(_captureScaleLayout,
+			 supportsCaptureScale(_entryData->_condition));
 
 	if (_entryData->_condition == VideoCondition::HAS_CHANGED ||
 	    _entryData->_condition == VideoCondition::HAS_NOT_CHANGED) {
-		_patternThreshold->setVisible(
-			_entryData->_usePatternForChangedCheck);
+		_patternThreshold->setVisible(_entryData->_changeDetection !=
+					      ChangeDetection::EXACT);
 	}
 
 	adjustSize();
@@ -827,22 +1360,34 @@ void MacroConditionVideoEdit::UpdateEntryData()
 	}
 
 	_videoSelection->SetVideoSelection(_entryData->_video);
-	_condition->setCurrentIndex(static_cast<int>(_entryData->_condition));
+	_condition->setCurrentIndex(
+		_condition->findData(static_cast<int>(_entryData->_condition)));
 	_imagePath->SetPath(QString::fromStdString(_entryData->_file));
-	_usePatternForChangedCheck->setChecked(
-		_entryData->_usePatternForChangedCheck);
+	_changeDetection->setCurrentIndex(
+		static_cast<int>(_entryData->_changeDetection));
 	_patternThreshold->SetDoubleValue(_entryData->_patternThreshold);
 	_useAlphaAsMask->setChecked(_entryData->_useAlphaAsMask);
+	_patternMatchMode->setCurrentIndex(
+		static_cast<int>(_entryData->_patternMatchMode));
 	_modelDataPath->SetPath(_entryData->GetModelDataPath().c_str());
 	_objectScaleThreshold->SetDoubleValue(_entryData->_scaleFactor);
 	_minNeighbors->setValue(_entryData->_minNeighbors);
 	_minSize->SetSize(_entryData->_minSize);
 	_maxSize->SetSize(_entryData->_maxSize);
+	_dnnConfidence->SetDoubleValue(_entryData->_dnnConfidence);
+	_dnnClassId->setValue(_entryData->_dnnClassId);
+	_dnnInputSize->setValue(_entryData->_dnnInputSize);
+	_text->setText(QString::fromStdString(_entryData->_text));
+	_useRegex->setChecked(_entryData->_useRegex);
+	_ocrLanguage->setText(QString::fromStdString(_entryData->_ocrLanguage));
+	UpdateColorPreview();
 	_throttleEnable->setChecked(_entryData->_throttleEnabled);
 	_throttleCount->setValue(_entryData->_throttleCount *
 				 GetSwitcher()->interval);
 	_checkAreaEnable->setChecked(_entryData->_checkAreaEnable);
 	_checkArea->SetArea(_entryData->_checkArea);
+	auto scaleIdx = _captureScale->findData(_entryData->_captureScale);
+	_captureScale->setCurrentIndex(scaleIdx != -1 ? scaleIdx : 0);
 	UpdatePreviewTooltip();
 	SetWidgetVisibility();
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include "opencv-helpers.hpp"
+#include "object-model.hpp"
 #include "threshold-slider.hpp"
 #include "preview-dialog.hpp"
 #include "area-selection.hpp"
@@ -8,6 +9,7 @@
 #include <macro.hpp>
 #include <file-selection.hpp>
 #include <screenshot-helper.hpp>
+#include <source-capture.hpp>
 
 #include <QWidget>
 #include <QComboBox>
@@ -15,7 +17,13 @@
 #include <QHBoxLayout>
 #include <QGridLayout>
 #include <QLabel>
+#include <QLineEdit>
+#include <QColor>
 #include <QRect>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
 
 enum class VideoCondition {
 	MATCH,
@@ -25,6 +33,59 @@ enum class VideoCondition {
 	NO_IMAGE,
 	PATTERN,
 	OBJECT,
+	TEXT,
+	COLOR,
+};
+
+// How frames are compared for the HAS_CHANGED and HAS_NOT_CHANGED conditions
+enum class ChangeDetection {
+	EXACT,
+	PATTERN,
+	DIFFERENCE,
+	HASH,
+};
+
+// Signatures of the most recently analyzed frames
+struct FrameHistory {
+	std::array<FrameSignature, 4> signatures;
+	size_t count = 0;
+	size_t next = 0;
+};
+
+// Snapshot of the settings of a video condition, so the analysis can be run
+// on a worker thread while the settings are being modified
+struct VideoAnalysisJob {
+	VideoCondition condition;
+	std::chrono::high_resolution_clock::time_point frameTime;
+	QImage screenshot;
+	QImage matchImage;
+	ChangeDetection changeDetection;
+	PatternMatchData patternData;
+	std::vector<ScaledPatternData> scaledPatternData;
+	PatternMatchMode patternMatchMode;
+	double patternThreshold;
+	bool useAlphaAsMask;
+	std::shared_ptr<ObjectModel> objectModel;
+	ObjectDetectionSettings objectDetection;
+	std::string text;
+	bool useRegex;
+	std::string ocrLanguage;
+	cv::Scalar color;
+};
+
+// Shared between a video condition and its analysis jobs, as a job might
+// still be running once the condition is deleted
+struct VideoAnalysisResult {
+	std::atomic_bool running = {false};
+	std::mutex mutex;
+	// Incremented to discard the result of the currently running job
+	uint64_t generation = 0;
+	bool valid = false;
+	bool match = false;
+	std::chrono::high_resolution_clock::time_point frameTime;
+	// Only accessed by the running job
+	FrameHistory history;
+	uint64_t historyGeneration = 0;
 };
 
 class MacroConditionVideo : public MacroCondition {
@@ -35,6 +96,7 @@ public:
 	bool Load(obs_data_t *obj);
 	std::string GetShortDesc();
 	std::string GetId() { return id; };
+	ConditionCost GetCost() { return ConditionCost::HIGH; }
 	QImage GetMatchImage() { return _matchImage; };
 	static std::shared_ptr<MacroCondition> Create(Macro *m)
 	{
@@ -44,20 +106,30 @@ public:
 	bool LoadImageFromFile();
 	bool LoadModelData(std::string &path);
 	std::string GetModelDataPath() { return _modelDataPath; }
-	void ResetLastMatch() { _lastMatchResult = false; }
+	void ResetLastMatch();
+	ObjectDetectionSettings GetObjectDetectionSettings(double scale = 1.);
+	bool UsesNeuralNetwork();
 
 	VideoSelection _video;
 	VideoCondition _condition = VideoCondition::MATCH;
 	std::string _file = obs_module_text("AdvSceneSwitcher.enterPath");
 	bool _useAlphaAsMask = false;
-	bool _usePatternForChangedCheck = false;
+	ChangeDetection _changeDetection = ChangeDetection::EXACT;
 	PatternMatchData _patternData;
+	PatternMatchMode _patternMatchMode = PatternMatchMode::FULL;
 	double _patternThreshold = 0.8;
-	cv::CascadeClassifier _objectCascade;
+	std::shared_ptr<ObjectModel> _objectModel;
 	double _scaleFactor = 1.1;
 	int _minNeighbors = minMinNeighbors;
 	advss::Size _minSize{0, 0};
 	advss::Size _maxSize{0, 0};
+	double _dnnConfidence = 0.5;
+	int _dnnClassId = -1;
+	int _dnnInputSize = 320;
+	std::string _text;
+	bool _useRegex = false;
+	std::string _ocrLanguage = "eng";
+	QColor _color = Qt::black;
 
 	bool _checkAreaEnable = false;
 	advss::Area _checkArea{0, 0, 0, 0};
@@ -65,22 +137,28 @@ public:
 	bool _throttleEnabled = false;
 	int _throttleCount = 3;
 
+	double _captureScale = 1.;
+
 private:
-	bool OutputChanged();
-	bool ScreenshotContainsPattern();
-	bool ScreenshotContainsObject();
-	bool Compare();
-	bool CheckShouldBeSkipped();
-
-	bool _getNextScreenshot = true;
-	ScreenshotHelper _screenshotData;
+	CaptureSettings GetCaptureSettings();
+	double GetCaptureScale();
+	std::chrono::milliseconds GetAnalysisInterval();
+	bool AnalysisDue();
+	bool StartAnalysis(SourceCapture::Frame &frame);
+	bool GetAnalysisResult();
+
+	std::shared_ptr<SourceCapture> _capture;
+	uint64_t _lastFrame = 0;
 	QImage _matchImage;
+	std::vector<ScaledPatternData> _scaledPatternData;
+	std::shared_ptr<VideoAnalysisResult> _analysis =
+		std::make_shared<VideoAnalysisResult>();
+	std::chrono::high_resolution_clock::time_point _lastAnalysis{};
+	bool _staleResultLogged = false;
 	std::string _modelDataPath =
 		obs_get_module_data_path(obs_current_module()) +
 		std::string(
 			"/res/cascadeClassifiers/haarcascade_frontalface_alt.xml");
-	bool _lastMatchResult = false;
-	int _runCount = 0;
 
 	static bool _registered;
 	static const std::string id;
@@ -106,14 +184,22 @@ public:
 
 private slots:
 	void VideoSelectionChanged(const VideoSelection &);
-	void ConditionChanged(int cond);
+	void ConditionChanged(int index);
 	void ImagePathChanged(const QString &text);
 	void ImageBrowseButtonClicked();
-	void UsePatternForChangedCheckChanged(int value);
+	void ChangeDetectionChanged(int index);
 	void PatternThresholdChanged(double);
 	void UseAlphaAsMaskChanged(int value);
+	void PatternMatchModeChanged(int index);
 
 	void ModelPathChanged(const QString &text);
+	void DNNConfidenceChanged(double value);
+	void DNNClassIdChanged(int value);
+	void DNNInputSizeChanged(int value);
+	void TextChanged();
+	void UseRegexChanged(int value);
+	void OCRLanguageChanged();
+	void SelectColorClicked();
 	void ObjectScaleThresholdChanged(double);
 	void MinNeighborsChanged(int value);
 	void MinSizeChanged(advss::Size value);
@@ -126,6 +212,7 @@ private slots:
 
 	void ThrottleEnableChanged(int value);
 	void ThrottleCountChanged(int value);
+	void CaptureScaleChanged(int index);
 	void ShowMatchClicked();
 signals:
 	void HeaderInfoChanged(const QString &);
@@ -134,10 +221,13 @@ protected:
 	VideoSelectionWidget *_videoSelection;
 	QComboBox *_condition;
 
-	QCheckBox *_usePatternForChangedCheck;
+	QHBoxLayout *_changeDetectionLayout;
+	QComboBox *_changeDetection;
 	FileSelection *_imagePath;
 	ThresholdSlider *_patternThreshold;
 	QCheckBox *_useAlphaAsMask;
+	QHBoxLayout *_patternMatchModeLayout;
+	QComboBox *_patternMatchMode;
 
 	FileSelection *_modelDataPath;
 	QHBoxLayout *_modelPathLayout;
@@ -148,6 +238,17 @@ protected:
 	QHBoxLayout *_sizeLayout;
 	SizeSelection *_minSize;
 	SizeSelection *_maxSize;
+	ThresholdSlider *_dnnConfidence;
+	QHBoxLayout *_dnnControlLayout;
+	QSpinBox *_dnnClassId;
+	QSpinBox *_dnnInputSize;
+	QHBoxLayout *_textLayout;
+	QLineEdit *_text;
+	QCheckBox *_useRegex;
+	QLineEdit *_ocrLanguage;
+	QHBoxLayout *_colorLayout;
+	QLabel *_colorPreview;
+	QPushButton *_selectColor;
 
 	QHBoxLayout *_checkAreaControlLayout;
 	QCheckBox *_checkAreaEnable;
@@ -158,6 +259,9 @@ protected:
 	QCheckBox *_throttleEnable;
 	QSpinBox *_throttleCount;
 
+	QHBoxLayout *_captureScaleLayout;
+	QComboBox *_captureScale;
+
 	QPushButton *_showMatch;
 	PreviewDialog _previewDialog;
 
@@ -165,5 +269,6 @@ protected:
 
 private:
 	void SetWidgetVisibility();
+	void UpdateColorPreview();
 	bool _loading = true;
 };
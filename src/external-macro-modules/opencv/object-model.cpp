@@ -0,0 +1,382 @@
+#include "object-model.hpp"
+
+#include <obs-module.h>
+#include <QFileInfo>
+#include <algorithm>
+#include <map>
+
+#ifdef HAVE_OPENCV_DNN
+constexpr size_t maxBatchSize = 8;
+constexpr float nmsThreshold = 0.45f;
+#endif
+
+typedef std::pair<std::string, int64_t> ModelKey;
+static std::mutex registryMutex;
+static std::map<ModelKey, std::weak_ptr<ObjectModel>> registry;
+
+static int64_t getModificationTime(const std::string &path)
+{
+	QFileInfo info(QString::fromStdString(path));
+	if (!info.exists()) {
+		return 0;
+	}
+	return info.lastModified().toMSecsSinceEpoch();
+}
+
+std::shared_ptr<ObjectModel> ObjectModel::Get(const std::string &path)
+{
+	ModelKey key(path, getModificationTime(path));
+	std::lock_guard<std::mutex> lock(registryMutex);
+	auto it = registry.find(key);
+	if (it != registry.end()) {
+		if (auto model = it->second.lock()) {
+			return model;
+		}
+	}
+
+	std::shared_ptr<ObjectModel> model(
+		new ObjectModel(key.first, key.second));
+	registry[key] = model;
+	return model;
+}
+
+bool ObjectModel::IsNeuralNetwork(const std::string &path)
+{
+	return QFileInfo(QString::fromStdString(path))
+		       .suffix()
+		       .compare("onnx", Qt::CaseInsensitive) == 0;
+}
+
+ObjectModel::ObjectModel(const std::string &path, int64_t modified)
+	: _path(path),
+	  _modified(modified),
+	  _isNeuralNetwork(IsNeuralNetwork(path))
+{
+}
+
+ObjectModel::~ObjectModel()
+{
+	std::lock_guard<std::mutex> lock(registryMutex);
+	auto it = registry.find(ModelKey(_path, _modified));
+	if (it != registry.end() && it->second.expired()) {
+		registry.erase(it);
+	}
+}
+
+bool ObjectModel::Load()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return LoadLocked();
+}
+
+#ifdef HAVE_OPENCV_DNN
+// The input shape is only known if the model does not use dynamic dimensions
+static size_t getSupportedBatchSize(cv::dnn::Net &net)
+{
+	try {
+		std::vector<cv::dnn::MatShape> inputs, outputs;
+		net.getLayerShapes(cv::dnn::MatShape(), 0, inputs, outputs);
+		if (!inputs.empty() && !inputs[0].empty() && inputs[0][0] > 0) {
+			return std::min((size_t)inputs[0][0], maxBatchSize);
+		}
+	} catch (const cv::Exception &) {
+	}
+	return maxBatchSize;
+}
+#endif
+
+bool ObjectModel::LoadLocked()
+{
+	if (_loaded) {
+		return _valid;
+	}
+	_loaded = true;
+
+	if (_isNeuralNetwork) {
+#ifdef HAVE_OPENCV_DNN
+		try {
+			_net = cv::dnn::readNetFromONNX(_path);
+			_net.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
+			_net.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+			_batchSize = getSupportedBatchSize(_net);
+		} catch (...) {
+			blog(LOG_WARNING, "failed to load model data \"%s\"",
+			     _path.c_str());
+		}
+		_valid = !_net.empty();
+		return _valid;
+#else
+		blog(LOG_WARNING,
+		     "cannot load \"%s\" - OpenCV was built without DNN support",
+		     _path.c_str());
+		return false;
+#endif
+	}
+
+	try {
+		_cascade.load(_path);
+	} catch (...) {
+		blog(LOG_WARNING, "failed to load model data \"%s\"",
+		     _path.c_str());
+	}
+	_valid = !_cascade.empty();
+	return _valid;
+}
+
+std::vector<cv::Rect>
+ObjectModel::Detect(const QImage &img, const ObjectDetectionSettings &settings)
+{
+	if (img.isNull()) {
+		return {};
+	}
+#ifdef HAVE_OPENCV_DNN
+	if (_isNeuralNetwork) {
+		return DetectNeuralNetwork(img, settings);
+	}
+#endif
+	return DetectCascade(img, settings);
+}
+
+std::vector<cv::Rect>
+ObjectModel::DetectCascade(const QImage &img,
+			   const ObjectDetectionSettings &settings)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (_isNeuralNetwork || !LoadLocked()) {
+		return {};
+	}
+	return matchObject(img, _cascade, settings.scaleFactor,
+			   settings.minNeighbors, settings.minSize,
+			   settings.maxSize);
+}
+
+#ifdef HAVE_OPENCV_DNN
+
+static bool isValidObjectSize(const cv::Rect &object,
+			      const ObjectDetectionSettings &settings)
+{
+	if (object.width < settings.minSize.width ||
+	    object.height < settings.minSize.height) {
+		return false;
+	}
+	if (settings.maxSize.width > 0 &&
+	    object.width > settings.maxSize.width) {
+		return false;
+	}
+	if (settings.maxSize.height > 0 &&
+	    object.height > settings.maxSize.height) {
+		return false;
+	}
+	return true;
+}
+
+std::vector<cv::Rect>
+ObjectModel::DetectNeuralNetwork(const QImage &img,
+				 const ObjectDetectionSettings &settings)
+{
+	DetectionRequest request;
+	cv::cvtColor(QImageToMat(img), request.image, cv::COLOR_RGBA2RGB);
+	request.settings = &settings;
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	if (!LoadLocked()) {
+		return {};
+	}
+
+	_pending.push_back(&request);
+	while (!request.done) {
+		if (_batchRunning) {
+			_batchDone.wait(lock);
+			continue;
+		}
+
+		// Requests with the same input size are processed together
+		std::vector<DetectionRequest *> batch;
+		int inputSize = _pending.front()->settings->inputSize;
+		for (auto it = _pending.begin();
+		     it != _pending.end() && batch.size() < _batchSize;) {
+			if ((*it)->settings->inputSize == inputSize) {
+				batch.push_back(*it);
+				it = _pending.erase(it);
+			} else {
+				++it;
+			}
+		}
+
+		_batchRunning = true;
+		lock.unlock();
+		RunBatch(batch, inputSize);
+		lock.lock();
+		for (auto r : batch) {
+			r->done = true;
+		}
+		_batchRunning = false;
+		_batchDone.notify_all();
+	}
+	return std::move(request.objects);
+}
+
+struct Detection {
+	int image;
+	int classId;
+	float confidence;
+	cv::Rect2f box; // Relative to the image size
+};
+
+// SSD style output: [1, 1, N, 7] rows of
+// [image, class, confidence, left, top, right, bottom] in relative coordinates
+static void parseSSDOutput(const cv::Mat &out, std::vector<Detection> &result)
+{
+	const int rows = (int)(out.total() / 7);
+	const float *data = out.ptr<float>();
+	for (int i = 0; i < rows; i++, data += 7) {
+		result.push_back({(int)data[0], (int)data[1], data[2],
+				  cv::Rect2f(data[3], data[4],
+					     data[5] - data[3],
+					     data[6] - data[4])});
+	}
+}
+
+// YOLO style output: [batch, N, 5 + classes] rows of
+// [cx, cy, w, h, objectness, scores...] or [batch, 4 + classes, N] without
+// objectness in input pixel coordinates
+static void parseYOLOOutput(const cv::Mat &out, int inputSize,
+			    std::vector<Detection> &result)
+{
+	const int batch = out.size[0];
+	const bool transposed = out.size[1] < out.size[2];
+	const int rows = transposed ? out.size[2] : out.size[1];
+	const int cols = transposed ? out.size[1] : out.size[2];
+	const int classOffset = transposed ? 4 : 5;
+	if (cols <= classOffset) {
+		return;
+	}
+
+	for (int b = 0; b < batch; b++) {
+		cv::Mat predictions(rows, cols, CV_32F,
+				    (void *)out.ptr<float>(b));
+		if (transposed) {
+			predictions = cv::Mat(cols, rows, CV_32F,
+					      (void *)out.ptr<float>(b))
+					      .t();
+		}
+		for (int i = 0; i < rows; i++) {
+			const float *row = predictions.ptr<float>(i);
+			cv::Mat scores(1, cols - classOffset, CV_32F,
+				       (void *)(row + classOffset));
+			double score;
+			cv::Point classId;
+			cv::minMaxLoc(scores, nullptr, &score, nullptr,
+				      &classId);
+			if (!transposed) {
+				score *= row[4];
+			}
+			float w = row[2] / inputSize;
+			float h = row[3] / inputSize;
+			result.push_back(
+				{b, classId.x, (float)score,
+				 cv::Rect2f(row[0] / inputSize - w / 2,
+					    row[1] / inputSize - h / 2, w,
+					    h)});
+		}
+	}
+}
+
+// Detections of the given images are numbered starting with firstImage
+static void runNet(cv::dnn::Net &net, const std::string &path,
+		   const std::vector<cv::Mat> &images, int inputSize,
+		   int firstImage, std::vector<Detection> &detections)
+{
+	// Models are expected to take RGB input in the range [0, 1]
+	auto blob = cv::dnn::blobFromImages(images, 1. / 255.,
+					    cv::Size(inputSize, inputSize),
+					    cv::Scalar(), false, false);
+	net.setInput(blob);
+	auto out = net.forward();
+
+	const size_t first = detections.size();
+	if (out.dims == 4 && out.size[3] == 7) {
+		parseSSDOutput(out, detections);
+	} else if (out.dims == 3) {
+		parseYOLOOutput(out, inputSize, detections);
+	} else {
+		blog(LOG_WARNING, "unsupported output format of model \"%s\"",
+		     path.c_str());
+	}
+	for (size_t i = first; i < detections.size(); i++) {
+		detections[i].image += firstImage;
+	}
+}
+
+void ObjectModel::RunBatch(std::vector<DetectionRequest *> &batch,
+			   int inputSize)
+{
+	std::vector<cv::Mat> images;
+	for (auto request : batch) {
+		images.push_back(request->image);
+	}
+
+	std::vector<Detection> detections;
+	bool runSeparately = false;
+	try {
+		runNet(_net, _path, images, inputSize, 0, detections);
+	} catch (const cv::Exception &e) {
+		if (images.size() == 1) {
+			blog(LOG_WARNING, "failed to run model \"%s\": %s",
+			     _path.c_str(), e.what());
+		} else {
+			// The batch size of the model is fixed even though its
+			// input shape did not indicate it
+			blog(LOG_INFO,
+			     "model \"%s\" does not support batches - processing images separately",
+			     _path.c_str());
+			_batchSize = 1;
+			runSeparately = true;
+		}
+	}
+
+	for (size_t i = 0; runSeparately && i < images.size(); i++) {
+		try {
+			runNet(_net, _path, {images[i]}, inputSize, (int)i,
+			       detections);
+		} catch (const cv::Exception &e) {
+			blog(LOG_WARNING, "failed to run model \"%s\": %s",
+			     _path.c_str(), e.what());
+		}
+	}
+
+	for (size_t i = 0; i < batch.size(); i++) {
+		auto request = batch[i];
+		const auto &settings = *request->settings;
+		const auto &size = request->image.size();
+
+		std::vector<cv::Rect> boxes;
+		std::vector<float> scores;
+		for (const auto &detection : detections) {
+			if (detection.image != (int)i ||
+			    detection.confidence < settings.confidence ||
+			    (settings.classId >= 0 &&
+			     detection.classId != settings.classId)) {
+				continue;
+			}
+			cv::Rect box(detection.box.x * size.width,
+				     detection.box.y * size.height,
+				     detection.box.width * size.width,
+				     detection.box.height * size.height);
+			if (!isValidObjectSize(box, settings)) {
+				continue;
+			}
+			boxes.push_back(box);
+			scores.push_back(detection.confidence);
+		}
+
+		std::vector<int> indices;
+		cv::dnn::NMSBoxes(boxes, scores, (float)settings.confidence,
+				  nmsThreshold, indices);
+		for (int idx : indices) {
+			request->objects.push_back(boxes[idx]);
+		}
+	}
+}
+
+#endif
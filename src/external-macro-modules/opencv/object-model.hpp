@@ -0,0 +1,81 @@
+#pragma once
+#include "opencv-helpers.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+
+struct ObjectDetectionSettings {
+	// Used by haar cascade classifiers
+	double scaleFactor = 1.1;
+	int minNeighbors = minMinNeighbors;
+	// Used by all models to filter the detected objects
+	cv::Size minSize;
+	cv::Size maxSize;
+	// Used by neural network models
+	double confidence = 0.5;
+	int classId = -1; // Any class
+	int inputSize = 320;
+};
+
+// Object detection model loaded from either a haar cascade classifier file
+// or an ONNX neural network model, which is run using OpenCV's DNN module.
+//
+// All conditions using the same file share a single model, which is only
+// parsed once it is actually needed.
+// The model is reloaded if the file was modified in the meantime.
+class ObjectModel {
+public:
+	static std::shared_ptr<ObjectModel> Get(const std::string &path);
+	static bool IsNeuralNetwork(const std::string &path);
+	~ObjectModel();
+
+	const std::string &GetPath() const { return _path; }
+	// Returns false if the model data could not be loaded
+	bool Load();
+	std::vector<cv::Rect> Detect(const QImage &img,
+				     const ObjectDetectionSettings &settings);
+
+private:
+	ObjectModel(const std::string &path, int64_t modified);
+	bool LoadLocked();
+	std::vector<cv::Rect>
+	DetectCascade(const QImage &img,
+		      const ObjectDetectionSettings &settings);
+
+	const std::string _path;
+	const int64_t _modified;
+	const bool _isNeuralNetwork;
+
+	// Detection is not guaranteed to be thread safe for a shared classifier
+	std::mutex _mutex;
+	bool _loaded = false;
+	bool _valid = false;
+	cv::CascadeClassifier _cascade;
+
+#ifdef HAVE_OPENCV_DNN
+	struct DetectionRequest {
+		cv::Mat image;
+		const ObjectDetectionSettings *settings;
+		std::vector<cv::Rect> objects;
+		bool done = false;
+	};
+
+	std::vector<cv::Rect>
+	DetectNeuralNetwork(const QImage &img,
+			    const ObjectDetectionSettings &settings);
+	void RunBatch(std::vector<DetectionRequest *> &batch, int inputSize);
+
+	cv::dnn::Net _net;
+	// Models exported with a fixed batch size only accept that many
+	// images per forward pass
+	size_t _batchSize = 1;
+	// Requests of all conditions using this model are combined into
+	// batches, which are processed by one of the waiting threads
+	std::deque<DetectionRequest *> _pending;
+	bool _batchRunning = false;
+	std::condition_variable _batchDone;
+#endif
+};
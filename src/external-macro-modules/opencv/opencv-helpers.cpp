@@ -1,65 +1,257 @@
 #include "opencv-helpers.hpp"
 
-PatternMatchData createPatternData(QImage &pattern)
+#include <cmath>
+#include <iterator>
+#include <memory>
+#include <util/base.h>
+
+#ifdef OCR_SUPPORT
+#include <tesseract/baseapi.h>
+#endif
+
+// The pattern is only downscaled as long as it stays at least this large, as
+// too small patterns would match almost everywhere
+constexpr int minCoarsePatternSize = 12;
+constexpr int maxCoarseLevel = 3;
+// Matches on the downscaled image are less accurate, so candidates are
+// accepted with a lower score and verified at full resolution
+constexpr double coarseThresholdMargin = 0.1;
+constexpr int maxCoarseCandidates = 16;
+constexpr double multiScaleFactors[] = {0.5, 0.75, 1., 1.25, 1.5, 2.};
+
+PatternMatchData createPatternData(const QImage &pattern)
 {
 	PatternMatchData data;
+	updatePatternData(pattern, data);
+	return data;
+}
+
+static int getCoarseLevel(const cv::Size &size)
+{
+	int level = 0;
+	while (level < maxCoarseLevel &&
+	       (size.width >> (level + 1)) >= minCoarsePatternSize &&
+	       (size.height >> (level + 1)) >= minCoarsePatternSize) {
+		level++;
+	}
+	return level;
+}
+
+static cv::Size getCoarseSize(const cv::Size &size, int level)
+{
+	return cv::Size(size.width >> level, size.height >> level);
+}
+
+// Reuses the buffers of data if the size of the pattern did not change
+void updatePatternData(const QImage &pattern, PatternMatchData &data)
+{
 	if (pattern.isNull()) {
-		return data;
+		data = {};
+		return;
 	}
 
-	data.rgbaPattern = QImageToMat(pattern);
-	std::vector<cv::Mat1b> rgbaChannelsPattern;
-	cv::split(data.rgbaPattern, rgbaChannelsPattern);
-	std::vector<cv::Mat1b> rgbChanlesPattern(
-		rgbaChannelsPattern.begin(), rgbaChannelsPattern.begin() + 3);
-	cv::merge(rgbChanlesPattern, data.rgbPattern);
-	cv::threshold(rgbaChannelsPattern[3], data.mask, 0, 255,
-		      cv::THRESH_BINARY);
-	return data;
+	// The pattern data has to stay valid even if the image is modified
+	QImageToMat(pattern).copyTo(data.rgbaPattern);
+	data.rgbPattern.create(data.rgbaPattern.size());
+	data.mask.create(data.rgbaPattern.size());
+
+	cv::Mat out[] = {data.rgbPattern, data.mask};
+	const int fromTo[] = {0, 0, 1, 1, 2, 2, 3, 3};
+	cv::mixChannels(&data.rgbaPattern, 1, out, 2, fromTo, 4);
+	cv::threshold(data.mask, data.mask, 0, 255, cv::THRESH_BINARY);
+
+	data.coarseLevel = getCoarseLevel(data.rgbaPattern.size());
+	if (data.coarseLevel == 0) {
+		return;
+	}
+	auto coarseSize =
+		getCoarseSize(data.rgbaPattern.size(), data.coarseLevel);
+	cv::resize(data.rgbaPattern, data.coarseRgbaPattern, coarseSize, 0, 0,
+		   cv::INTER_AREA);
+	cv::resize(data.rgbPattern, data.coarseRgbPattern, coarseSize, 0, 0,
+		   cv::INTER_AREA);
+	cv::resize(data.mask, data.coarseMask, coarseSize, 0, 0,
+		   cv::INTER_NEAREST);
 }
 
-void matchPattern(QImage &img, PatternMatchData &patternData, double threshold,
-		  cv::Mat &result, bool useAlphaAsMask)
+void updateScaledPatternData(const QImage &pattern,
+			     std::vector<ScaledPatternData> &data)
+{
+	data.resize(std::size(multiScaleFactors));
+	for (size_t i = 0; i < data.size(); i++) {
+		double scale = multiScaleFactors[i];
+		data[i].scale = scale;
+		if (scale == 1. || pattern.isNull()) {
+			updatePatternData(pattern, data[i].data);
+			continue;
+		}
+		auto scaled = pattern.scaled(
+			std::lround(pattern.width() * scale),
+			std::lround(pattern.height() * scale),
+			Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+		updatePatternData(scaled, data[i].data);
+	}
+}
+
+static void runMatchTemplate(const cv::Mat &image, const cv::Mat &rgbaPattern,
+			     const cv::Mat &rgbPattern, const cv::Mat &mask,
+			     cv::Mat &result, bool useAlphaAsMask)
+{
+	if (useAlphaAsMask) {
+		cv::matchTemplate(image, rgbPattern, result,
+				  cv::TM_CCORR_NORMED, mask);
+	} else {
+		cv::matchTemplate(image, rgbaPattern, result,
+				  cv::TM_CCOEFF_NORMED);
+	}
+}
+
+// Searches the downscaled image for candidates and only matches the pattern
+// at full resolution in the area surrounding those candidates
+static void matchCoarseToFine(const cv::Mat &image,
+			      const PatternMatchData &patternData,
+			      double threshold, cv::Mat &result,
+			      bool useAlphaAsMask)
+{
+	const int level = patternData.coarseLevel;
+	const int factor = 1 << level;
+	const auto &pattern = patternData.rgbaPattern;
+
+	thread_local cv::Mat coarseImage;
+	thread_local cv::Mat coarseResult;
+	thread_local cv::Mat refineResult;
+	cv::resize(image, coarseImage, getCoarseSize(image.size(), level), 0,
+		   0, cv::INTER_AREA);
+	runMatchTemplate(coarseImage, patternData.coarseRgbaPattern,
+			 patternData.coarseRgbPattern, patternData.coarseMask,
+			 coarseResult, useAlphaAsMask);
+
+	result.create(image.rows - pattern.rows + 1,
+		      image.cols - pattern.cols + 1, CV_32F);
+	result.setTo(0);
+	const cv::Rect resultArea(0, 0, result.cols, result.rows);
+	const auto coarsePatternSize = patternData.coarseRgbaPattern.size();
+
+	for (int i = 0; i < maxCoarseCandidates; i++) {
+		double score;
+		cv::Point pos;
+		cv::minMaxLoc(coarseResult, nullptr, &score, nullptr, &pos);
+		if (score < threshold - coarseThresholdMargin) {
+			break;
+		}
+
+		// Suppress overlapping candidates
+		cv::rectangle(coarseResult,
+			      cv::Rect(pos.x - coarsePatternSize.width / 2,
+				       pos.y - coarsePatternSize.height / 2,
+				       coarsePatternSize.width,
+				       coarsePatternSize.height),
+			      cv::Scalar(-1), cv::FILLED);
+
+		cv::Rect area(pos.x * factor - factor, pos.y * factor - factor,
+			      2 * factor + 1, 2 * factor + 1);
+		area &= resultArea;
+		if (area.empty()) {
+			continue;
+		}
+		cv::Rect imageArea(area.x, area.y,
+				   area.width + pattern.cols - 1,
+				   area.height + pattern.rows - 1);
+		runMatchTemplate(image(imageArea), patternData.rgbaPattern,
+				 patternData.rgbPattern, patternData.mask,
+				 refineResult, useAlphaAsMask);
+		cv::threshold(refineResult, refineResult, threshold, 0,
+			      cv::THRESH_TOZERO);
+		cv::Mat target = result(area);
+		cv::max(target, refineResult, target);
+	}
+}
+
+void matchPattern(const QImage &img, const PatternMatchData &patternData,
+		  double threshold, cv::Mat &result, bool useAlphaAsMask,
+		  bool coarseToFine)
 {
 	if (img.isNull() || patternData.rgbaPattern.empty()) {
+		result.release();
 		return;
 	}
 	if (img.height() < patternData.rgbaPattern.rows ||
 	    img.width() < patternData.rgbaPattern.cols) {
+		result.release();
 		return;
 	}
 
 	auto i = QImageToMat(img);
+	cv::Mat image = i;
 
 	if (useAlphaAsMask) {
-		std::vector<cv::Mat1b> rgbaChannelsImage;
-		cv::split(i, rgbaChannelsImage);
-		std::vector<cv::Mat1b> rgbChanlesImage(
-			rgbaChannelsImage.begin(),
-			rgbaChannelsImage.begin() + 3);
+		// Only reallocated if the size of the screenshot changes
+		thread_local cv::Mat3b rgbImage;
+		rgbImage.create(i.size());
+		const int fromTo[] = {0, 0, 1, 1, 2, 2};
+		cv::mixChannels(&i, 1, &rgbImage, 1, fromTo, 3);
+		image = rgbImage;
+	}
 
-		cv::Mat3b rgbImage;
-		cv::merge(rgbChanlesImage, rgbImage);
+	if (coarseToFine && patternData.coarseLevel > 0) {
+		matchCoarseToFine(image, patternData, threshold, result,
+				  useAlphaAsMask);
+		return;
+	}
 
-		cv::matchTemplate(rgbImage, patternData.rgbPattern, result,
-				  cv::TM_CCORR_NORMED, patternData.mask);
-		cv::threshold(result, result, threshold, 0, cv::THRESH_TOZERO);
+	runMatchTemplate(image, patternData.rgbaPattern, patternData.rgbPattern,
+			 patternData.mask, result, useAlphaAsMask);
+	cv::threshold(result, result, threshold, 0, cv::THRESH_TOZERO);
+}
 
-	} else {
-		cv::matchTemplate(i, patternData.rgbaPattern, result,
-				  cv::TM_CCOEFF_NORMED);
-		cv::threshold(result, result, threshold, 0, cv::THRESH_TOZERO);
+// Returns the scale of the best matching pattern or 0 if there was no match
+double matchPatternMultiScale(const QImage &img,
+			      const std::vector<ScaledPatternData> &patternData,
+			      double threshold, cv::Mat &result,
+			      bool useAlphaAsMask)
+{
+	thread_local cv::Mat scaleResult;
+	double bestScale = 0.;
+	double bestScore = 0.;
+	for (const auto &pattern : patternData) {
+		matchPattern(img, pattern.data, threshold, scaleResult,
+			     useAlphaAsMask, true);
+		if (scaleResult.empty()) {
+			continue;
+		}
+		double score;
+		cv::minMaxLoc(scaleResult, nullptr, &score);
+		if (score > bestScore) {
+			bestScore = score;
+			bestScale = pattern.scale;
+			cv::swap(result, scaleResult);
+		}
+	}
+	if (bestScale == 0.) {
+		result.release();
 	}
+	return bestScale;
 }
 
-void matchPattern(QImage &img, QImage &pattern, double threshold,
-		  cv::Mat &result, bool useAlphaAsMask)
+// Returns the scale of the best matching pattern or 0 if there was no match
+double matchPattern(QImage &img, QImage &pattern, double threshold,
+		    cv::Mat &result, bool useAlphaAsMask, PatternMatchMode mode)
 {
+	if (mode == PatternMatchMode::MULTI_SCALE) {
+		std::vector<ScaledPatternData> data;
+		updateScaledPatternData(pattern, data);
+		return matchPatternMultiScale(img, data, threshold, result,
+					      useAlphaAsMask);
+	}
+
 	auto data = createPatternData(pattern);
-	matchPattern(img, data, threshold, result, useAlphaAsMask);
+	matchPattern(img, data, threshold, result, useAlphaAsMask,
+		     mode == PatternMatchMode::PYRAMID);
+	return cv::countNonZero(result) > 0 ? 1. : 0.;
 }
 
-std::vector<cv::Rect> matchObject(QImage &img, cv::CascadeClassifier &cascade,
+std::vector<cv::Rect> matchObject(const QImage &img,
+				  cv::CascadeClassifier &cascade,
 				  double scaleFactor, int minNeighbors,
 				  cv::Size minSize, cv::Size maxSize)
 {
@@ -68,7 +260,7 @@ std::vector<cv::Rect> matchObject(QImage &img, cv::CascadeClassifier &cascade,
 	}
 
 	auto i = QImageToMat(img);
-	cv::Mat frameGray;
+	thread_local cv::Mat frameGray;
 	cv::cvtColor(i, frameGray, cv::COLOR_BGR2GRAY);
 	equalizeHist(frameGray, frameGray);
 	std::vector<cv::Rect> objects;
@@ -77,7 +269,130 @@ std::vector<cv::Rect> matchObject(QImage &img, cv::CascadeClassifier &cascade,
 	return objects;
 }
 
+// The thumbnail is small enough that comparing it is negligible, but still
+// preserves coarse changes like moving objects or scene transitions
+static const cv::Size thumbnailSize(32, 32);
+// dHash compares neighbouring pixels of a 9x8 image resulting in 64 bits
+static const cv::Size hashSize(9, 8);
+
+// Reuses the buffers of signature if possible
+void updateFrameSignature(const QImage &img, FrameSignature &signature)
+{
+	if (img.isNull()) {
+		signature.thumbnail.release();
+		signature.hash = 0;
+		return;
+	}
+
+	// Downscale first, so the color conversion only touches a few pixels
+	thread_local cv::Mat rgbaThumbnail;
+	thread_local cv::Mat1b hashImage;
+	cv::resize(QImageToMat(img), rgbaThumbnail, thumbnailSize, 0, 0,
+		   cv::INTER_AREA);
+	cv::cvtColor(rgbaThumbnail, signature.thumbnail, cv::COLOR_RGBA2GRAY);
+	cv::resize(signature.thumbnail, hashImage, hashSize, 0, 0,
+		   cv::INTER_AREA);
+
+	uint64_t hash = 0;
+	for (int row = 0; row < hashImage.rows; row++) {
+		const uchar *pixel = hashImage.ptr<uchar>(row);
+		for (int col = 0; col < hashImage.cols - 1; col++) {
+			hash = (hash << 1) | (pixel[col] > pixel[col + 1]);
+		}
+	}
+	signature.hash = hash;
+}
+
+// Returns the mean absolute difference of the signatures in the range [0, 1]
+double getFrameDifference(const FrameSignature &a, const FrameSignature &b)
+{
+	if (a.thumbnail.empty() || b.thumbnail.empty()) {
+		return a.thumbnail.empty() == b.thumbnail.empty() ? 0. : 1.;
+	}
+	return cv::norm(a.thumbnail, b.thumbnail, cv::NORM_L1) /
+	       (255. * a.thumbnail.total());
+}
+
+// Returns the share of differing bits of the perceptual hashes
+double getHashDifference(const FrameSignature &a, const FrameSignature &b)
+{
+	if (a.thumbnail.empty() || b.thumbnail.empty()) {
+		return a.thumbnail.empty() == b.thumbnail.empty() ? 0. : 1.;
+	}
+	uint64_t diff = a.hash ^ b.hash;
+	int bits = 0;
+	while (diff) {
+		diff &= diff - 1;
+		bits++;
+	}
+	return bits / 64.;
+}
+
+// Returns the average RGB color of the image ignoring the alpha channel
+cv::Scalar getMeanColor(const QImage &img)
+{
+	if (img.isNull()) {
+		return cv::Scalar();
+	}
+	auto mean = cv::mean(QImageToMat(img));
+	return cv::Scalar(mean[0], mean[1], mean[2]);
+}
+
+// Returns the euclidean distance of the RGB colors in the range [0, 1]
+double getColorDifference(const cv::Scalar &a, const cv::Scalar &b)
+{
+	static const double maxDistance = std::sqrt(3. * 255. * 255.);
+	double sum = 0.;
+	for (int i = 0; i < 3; i++) {
+		sum += (a[i] - b[i]) * (a[i] - b[i]);
+	}
+	return std::sqrt(sum) / maxDistance;
+}
+
+#ifdef OCR_SUPPORT
+
+// Initializing Tesseract is expensive, so each thread keeps its own engine
+struct OCREngine {
+	std::unique_ptr<tesseract::TessBaseAPI> api;
+	std::string language;
+	bool initialized = false;
+};
+
+// Returns the text found in the image
+std::string recognizeText(const QImage &img, const std::string &language)
+{
+	if (img.isNull()) {
+		return "";
+	}
+
+	thread_local OCREngine engine;
+	if (!engine.api || engine.language != language) {
+		engine.api = std::make_unique<tesseract::TessBaseAPI>();
+		engine.language = language;
+		engine.initialized =
+			engine.api->Init(nullptr, language.c_str()) == 0;
+		if (!engine.initialized) {
+			blog(LOG_WARNING,
+			     "failed to initialize OCR for language \"%s\"",
+			     language.c_str());
+		}
+	}
+	if (!engine.initialized) {
+		return "";
+	}
+
+	thread_local cv::Mat gray;
+	cv::cvtColor(QImageToMat(img), gray, cv::COLOR_RGBA2GRAY);
+	engine.api->SetImage(gray.data, gray.cols, gray.rows, 1,
+			     (int)gray.step);
+	std::unique_ptr<char[]> text(engine.api->GetUTF8Text());
+	return text ? std::string(text.get()) : "";
+}
+
+#endif
+
 // Assumption is that QImage uses Format_RGBA8888.
+// The returned matrix shares the data of the image without detaching it.
 // Conversion from: https://github.com/dbzhang800/QtOpenCV
 cv::Mat QImageToMat(const QImage &img)
 {
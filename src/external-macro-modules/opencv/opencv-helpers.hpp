@@ -6,19 +6,63 @@
 constexpr int minMinNeighbors = 3;
 constexpr int maxMinNeighbors = 6;
 
+enum class PatternMatchMode {
+	// Search the whole image at full resolution
+	FULL,
+	// Search a downscaled image first and only refine the candidates
+	PYRAMID,
+	// Like PYRAMID, but also search for scaled versions of the pattern
+	MULTI_SCALE,
+};
+
 struct PatternMatchData {
 	cv::Mat4b rgbaPattern;
 	cv::Mat3b rgbPattern;
 	cv::Mat1b mask;
+
+	// Downscaled by 2^coarseLevel for the coarse search
+	int coarseLevel = 0;
+	cv::Mat4b coarseRgbaPattern;
+	cv::Mat3b coarseRgbPattern;
+	cv::Mat1b coarseMask;
+};
+
+struct ScaledPatternData {
+	double scale;
+	PatternMatchData data;
+};
+
+// Compact representation of a frame used for fast change detection
+struct FrameSignature {
+	cv::Mat1b thumbnail;
+	uint64_t hash = 0;
 };
 
-PatternMatchData createPatternData(QImage &pattern);
-void matchPattern(QImage &img, PatternMatchData &patternData, double threshold,
-		  cv::Mat &result, bool useAlphaAsMask = true);
-void matchPattern(QImage &img, QImage &pattern, double threshold,
-		  cv::Mat &result, bool useAlphaAsMask);
-std::vector<cv::Rect> matchObject(QImage &img, cv::CascadeClassifier &cascade,
+PatternMatchData createPatternData(const QImage &pattern);
+void updatePatternData(const QImage &pattern, PatternMatchData &data);
+void updateScaledPatternData(const QImage &pattern,
+			     std::vector<ScaledPatternData> &data);
+void matchPattern(const QImage &img, const PatternMatchData &patternData,
+		  double threshold, cv::Mat &result, bool useAlphaAsMask = true,
+		  bool coarseToFine = false);
+double matchPatternMultiScale(const QImage &img,
+			      const std::vector<ScaledPatternData> &patternData,
+			      double threshold, cv::Mat &result,
+			      bool useAlphaAsMask = true);
+double matchPattern(QImage &img, QImage &pattern, double threshold,
+		    cv::Mat &result, bool useAlphaAsMask,
+		    PatternMatchMode mode = PatternMatchMode::FULL);
+std::vector<cv::Rect> matchObject(const QImage &img,
+				  cv::CascadeClassifier &cascade,
 				  double scaleFactor, int minNeighbors,
 				  cv::Size minSize, cv::Size maxSize);
+void updateFrameSignature(const QImage &img, FrameSignature &signature);
+double getFrameDifference(const FrameSignature &a, const FrameSignature &b);
+double getHashDifference(const FrameSignature &a, const FrameSignature &b);
+cv::Scalar getMeanColor(const QImage &img);
+double getColorDifference(const cv::Scalar &a, const cv::Scalar &b);
+#ifdef OCR_SUPPORT
+std::string recognizeText(const QImage &img, const std::string &language);
+#endif
 cv::Mat QImageToMat(const QImage &img);
 QImage MatToQImage(const cv::Mat &mat);
@@ -3,6 +3,7 @@
 #include "opencv-helpers.hpp"
 #include "utility.hpp"
 
+#include <cmath>
 #include <condition_variable>
 
 PreviewDialog::PreviewDialog(QWidget *parent,
@@ -171,15 +172,16 @@ void PreviewDialog::CheckForMatchLoop()
 	}
 }
 
-void markPatterns(cv::Mat &matchResult, QImage &image, QImage &pattern)
+void markPatterns(cv::Mat &matchResult, QImage &image,
+		  const cv::Size &patternSize)
 {
 	auto matchImg = QImageToMat(image);
 	for (int row = 0; row < matchResult.rows - 1; row++) {
 		for (int col = 0; col < matchResult.cols - 1; col++) {
 			if (matchResult.at<float>(row, col) != 0.0) {
 				rectangle(matchImg, {col, row},
-					  cv::Point(col + pattern.width(),
-						    row + pattern.height()),
+					  cv::Point(col + patternSize.width,
+						    row + patternSize.height),
 					  cv::Scalar(255, 0, 0, 255), 2, 8, 0);
 			}
 		}
@@ -202,24 +204,29 @@ void PreviewDialog::MarkMatch(QImage &screenshot)
 	if (_conditionData->_condition == VideoCondition::PATTERN) {
 		cv::Mat result;
 		QImage pattern = _conditionData->GetMatchImage();
-		matchPattern(screenshot, pattern,
-			     _conditionData->_patternThreshold, result,
-			     _conditionData->_useAlphaAsMask);
+		double scale = matchPattern(screenshot, pattern,
+					    _conditionData->_patternThreshold,
+					    result,
+					    _conditionData->_useAlphaAsMask,
+					    _conditionData->_patternMatchMode);
 		if (countNonZero(result) == 0) {
 			_statusLabel->setText(obs_module_text(
 				"AdvSceneSwitcher.condition.video.patternMatchFail"));
 		} else {
 			_statusLabel->setText(obs_module_text(
 				"AdvSceneSwitcher.condition.video.patternMatchSuccess"));
-			markPatterns(result, screenshot, pattern);
+			cv::Size patternSize(std::lround(pattern.width() * scale),
+					     std::lround(pattern.height() * scale));
+			markPatterns(result, screenshot, patternSize);
 		}
 	} else if (_conditionData->_condition == VideoCondition::OBJECT) {
-		auto objects = matchObject(screenshot,
-					   _conditionData->_objectCascade,
-					   _conditionData->_scaleFactor,
-					   _conditionData->_minNeighbors,
-					   _conditionData->_minSize.CV(),
-					   _conditionData->_maxSize.CV());
+		auto model = _conditionData->_objectModel;
+		std::vector<cv::Rect> objects;
+		if (model) {
+			objects = model->Detect(
+				screenshot,
+				_conditionData->GetObjectDetectionSettings());
+		}
 		if (objects.empty()) {
 			_statusLabel->setText(obs_module_text(
 				"AdvSceneSwitcher.condition.video.objectMatchFail"));
@@ -228,6 +235,34 @@ void PreviewDialog::MarkMatch(QImage &screenshot)
 				"AdvSceneSwitcher.condition.video.objectMatchSuccess"));
 			markObjects(screenshot, objects);
 		}
+	} else if (_conditionData->_condition == VideoCondition::COLOR) {
+		QImage image = screenshot;
+		if (_conditionData->_checkAreaEnable) {
+			const auto &area = _conditionData->_checkArea;
+			image = screenshot.copy(area.x, area.y, area.width,
+						area.height);
+		}
+		auto mean = getMeanColor(image);
+		QColor color(std::lround(mean[0]), std::lround(mean[1]),
+			     std::lround(mean[2]));
+		_statusLabel->setText(
+			QString(obs_module_text(
+					"AdvSceneSwitcher.condition.video.colorMatch"))
+				.arg(color.name()));
+#ifdef OCR_SUPPORT
+	} else if (_conditionData->_condition == VideoCondition::TEXT) {
+		QImage image = screenshot;
+		if (_conditionData->_checkAreaEnable) {
+			const auto &area = _conditionData->_checkArea;
+			image = screenshot.copy(area.x, area.y, area.width,
+						area.height);
+		}
+		auto text = recognizeText(image, _conditionData->_ocrLanguage);
+		_statusLabel->setText(
+			QString(obs_module_text(
+					"AdvSceneSwitcher.condition.video.textMatch"))
+				.arg(QString::fromStdString(text).simplified()));
+#endif
 	}
 }
 
@@ -0,0 +1,60 @@
+#pragma once
+#include <obs.hpp>
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+class Macro;
+
+enum class FadeCurve {
+	LINEAR,
+	// Linear in dB, which is perceived as a steady change in loudness
+	LOGARITHMIC,
+	// Starts and ends slowly
+	S_CURVE,
+};
+
+// Fades the volume of a source or the master volume.
+//
+// All active fades are advanced from a single OBS tick callback, which sets the
+// volume according to the time passed since the start of the fade.
+// So the volume is updated once per video frame no matter how many fades are
+// active, no thread has to sleep in between the steps, and timing jitter does
+// not accumulate.
+class AudioFade {
+public:
+	// Pass nullptr as source to fade the master volume.
+	// Returns nullptr if a fade for the same source is already active and
+	// abortActive is not set.
+	static std::shared_ptr<AudioFade> Start(Macro *macro,
+						const OBSWeakSource &source,
+						float volume, double seconds,
+						FadeCurve curve,
+						bool abortActive);
+	// Aborts all fades started by the given macro
+	static void Stop(Macro *macro);
+
+	static float GetVolume(const OBSWeakSource &source);
+	static void SetVolume(const OBSWeakSource &source, float volume);
+
+	// Blocks until the fade is completed or aborted
+	void Wait();
+	bool Done() const { return _done; }
+
+private:
+	AudioFade(Macro *macro, const OBSWeakSource &source, float volume,
+		  double seconds, FadeCurve curve);
+	static void Tick(void *, float);
+	// Returns true once the target volume was reached
+	bool Update(std::chrono::high_resolution_clock::time_point now);
+	float GetVolumeAt(double progress) const;
+
+	Macro *_macro;
+	OBSWeakSource _source;
+	float _startVolume;
+	float _endVolume;
+	double _seconds;
+	FadeCurve _curve;
+	std::chrono::high_resolution_clock::time_point _startTime;
+	std::atomic_bool _done = {false};
+};
@@ -0,0 +1,148 @@
+#pragma once
+#include <obs.hpp>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <mutex>
+
+struct AudioLevelStats {
+	// Number of level updates within the window
+	size_t count = 0;
+	// All levels in dBFS
+	float maxPeak = -std::numeric_limits<float>::infinity();
+	float avgPeak = -std::numeric_limits<float>::infinity();
+	float rms = -std::numeric_limits<float>::infinity();
+};
+
+// Ring buffer of timestamped value pairs with a single writer.
+// Readers never modify the ring buffer, so any number of them can read the
+// most recent entries concurrently without taking any locks.
+class AudioLevelRing {
+public:
+	void Push(int64_t time, float first, float second);
+	uint64_t GetCount() const { return _writeCount; }
+
+	// Calls f(first, second) for each entry not older than start, starting
+	// with the most recent one
+	template<typename F> void ForEach(int64_t start, F &&f) const
+	{
+		const uint64_t count =
+			_writeCount.load(std::memory_order_acquire);
+		const uint64_t oldest =
+			count > _capacity ? count - _capacity : 0;
+		for (uint64_t idx = count; idx > oldest; idx--) {
+			const auto &entry = _entries[(idx - 1) % _capacity];
+			const uint64_t sequence = 2 * (idx - 1) + 2;
+			if (entry.sequence.load(std::memory_order_acquire) !=
+			    sequence) {
+				return;
+			}
+			const int64_t time =
+				entry.time.load(std::memory_order_relaxed);
+			const float first =
+				entry.first.load(std::memory_order_relaxed);
+			const float second =
+				entry.second.load(std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_acquire);
+			// Entry was overwritten by the writer while reading it
+			if (entry.sequence.load(std::memory_order_relaxed) !=
+				    sequence ||
+			    time < start) {
+				return;
+			}
+			f(first, second);
+		}
+	}
+
+private:
+	// Roughly ten seconds of level updates
+	static constexpr size_t _capacity = 512;
+
+	struct Entry {
+		// Odd while the entry is being written
+		std::atomic<uint64_t> sequence = {0};
+		std::atomic<int64_t> time = {0};
+		std::atomic<float> first = {0.f};
+		std::atomic<float> second = {0.f};
+	};
+
+	Entry _entries[_capacity];
+	std::atomic<uint64_t> _writeCount = {0};
+};
+
+// Measures the audio levels of a source.
+//
+// All users of the same source share a single volmeter, so the levels are only
+// computed once no matter how many conditions depend on them.
+// The volmeter callback publishes each update into a ring buffer, which can be
+// queried for statistics over the most recent updates.
+//
+// Optionally the loudness according to ITU-R BS.1770 can be measured as well.
+// The K-weighted power of each block of audio data is published into a second
+// ring buffer, so the momentary (400 ms), short-term (3 s) or any other
+// ungated loudness of up to ten seconds can be computed from it.
+class AudioMeter {
+public:
+	static std::shared_ptr<AudioMeter> Get(const OBSWeakSource &source);
+	~AudioMeter();
+
+	OBSWeakSource GetSource() const { return _source; }
+	// Statistics over all updates received within the given time window
+	AudioLevelStats GetStats(std::chrono::milliseconds window) const;
+	// Increased for each level update received from the volmeter
+	uint64_t GetUpdateCount() const { return _levels.GetCount(); }
+
+	// Volume thresholds in the 0 to 100 range used by the audio conditions.
+	// The switcher thread is woken up whenever the peak crosses one of the
+	// registered thresholds.
+	void AddWakeupThreshold(int threshold);
+	void RemoveWakeupThreshold(int threshold);
+
+	// The loudness is only measured as long as it is enabled by at least
+	// one user
+	void EnableLoudness();
+	void DisableLoudness();
+	// Loudness in LUFS over the given time window
+	double GetLoudness(std::chrono::milliseconds window) const;
+
+	// Maps a peak value of -60 dB to 0 dB to the 0 to 100 range
+	static double PeakToVolume(float peak);
+
+private:
+	AudioMeter(const OBSWeakSource &source);
+	static void SetVolumeLevel(void *data,
+				   const float magnitude[MAX_AUDIO_CHANNELS],
+				   const float peak[MAX_AUDIO_CHANNELS],
+				   const float inputPeak[MAX_AUDIO_CHANNELS]);
+	static void ProcessAudio(void *data, obs_source_t *source,
+				 const struct audio_data *audio, bool muted);
+	void CheckWakeupThresholds(float peak);
+	void UpdateFilters(uint32_t sampleRate);
+
+	static constexpr int _maxThreshold = 100;
+
+	OBSWeakSource _source;
+	obs_volmeter_t *_volmeter = nullptr;
+	// Peak and magnitude in dBFS
+	AudioLevelRing _levels;
+
+	std::atomic_int _thresholdCount = {0};
+	std::atomic_int _thresholds[_maxThreshold + 1] = {};
+	// Only accessed from within the volmeter callback
+	float _lastPeak = -std::numeric_limits<float>::infinity();
+
+	std::mutex _loudnessMutex;
+	int _loudnessUsers = 0;
+	// K-weighted mean square power and the number of frames it covers
+	AudioLevelRing _loudness;
+
+	// K-weighting filter, only accessed from within the audio callback
+	struct Biquad {
+		double b[3] = {1., 0., 0.};
+		double a[3] = {1., 0., 0.};
+	};
+	uint32_t _filterSampleRate = 0;
+	Biquad _filters[2];
+	double _filterState[MAX_AUDIO_CHANNELS][2][4] = {};
+};
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+constexpr auto logic_root_offset = 100;
+
+enum class LogicType {
+	ROOT_NONE = 0,
+	ROOT_NOT,
+	ROOT_LAST,
+	// leave some space for potential expansion
+	NONE = 100,
+	AND,
+	OR,
+	AND_NOT,
+	OR_NOT,
+	LAST,
+};
+
+static inline bool isRootLogicType(LogicType l)
+{
+	return static_cast<int>(l) < logic_root_offset;
+}
+
+// Rough estimate of how expensive it is to check a condition
+enum class ConditionCost {
+	LOW,
+	MEDIUM,
+	HIGH,
+};
+
+// Combines the results of a list of conditions from left to right.
+//
+// If short-circuit evaluation is enabled conditions, which can no longer
+// change the result, are skipped.
+// If reordering is enabled consecutive conditions using the same type of
+// logic are checked in the order of their cost, as their order does not
+// change the result.
+class ConditionLogicChain {
+public:
+	void Clear();
+	// Conditions which have to be checked each interval (e.g. because
+	// they are using duration modifiers) must not be skippable
+	void Add(LogicType logic, ConditionCost cost, bool skippable);
+	bool Evaluate(bool shortCircuit, bool reorder,
+		      const std::function<bool(size_t)> &check,
+		      const std::function<void(size_t)> &skip = nullptr);
+
+private:
+	struct Entry {
+		LogicType logic;
+		ConditionCost cost;
+		bool skippable;
+	};
+
+	LogicType GetRootCombineLogic();
+	void SortByCost(LogicType rootLogic);
+
+	std::vector<Entry> _entries;
+	std::vector<size_t> _order;
+};
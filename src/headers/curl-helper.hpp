@@ -14,11 +14,33 @@ typedef CURL *(*initFunction)(void);
 typedef CURLcode (*setOptFunction)(CURL *, CURLoption, ...);
 typedef CURLcode (*performFunction)(CURL *);
 typedef void (*cleanupFunction)(CURL *);
+typedef CURLcode (*getInfoFunction)(CURL *, CURLINFO, ...);
+typedef struct curl_slist *(*slistAppendFunction)(struct curl_slist *,
+						  const char *);
+typedef void (*slistFreeAllFunction)(struct curl_slist *);
+typedef CURLM *(*multiInitFunction)(void);
+typedef CURLMcode (*multiAddHandleFunction)(CURLM *, CURL *);
+typedef CURLMcode (*multiRemoveHandleFunction)(CURLM *, CURL *);
+typedef CURLMcode (*multiPerformFunction)(CURLM *, int *);
+typedef CURLMcode (*multiWaitFunction)(CURLM *, struct curl_waitfd[],
+				       unsigned int, int, int *);
+typedef CURLMsg *(*multiInfoReadFunction)(CURLM *, int *);
+typedef CURLMcode (*multiCleanupFunction)(CURLM *);
 
 extern initFunction f_curl_init;
 extern setOptFunction f_curl_setopt;
 extern performFunction f_curl_perform;
 extern cleanupFunction f_curl_cleanup;
+extern getInfoFunction f_curl_getinfo;
+extern slistAppendFunction f_curl_slist_append;
+extern slistFreeAllFunction f_curl_slist_free_all;
+extern multiInitFunction f_curl_multi_init;
+extern multiAddHandleFunction f_curl_multi_add_handle;
+extern multiRemoveHandleFunction f_curl_multi_remove_handle;
+extern multiPerformFunction f_curl_multi_perform;
+extern multiWaitFunction f_curl_multi_wait;
+extern multiInfoReadFunction f_curl_multi_info_read;
+extern multiCleanupFunction f_curl_multi_cleanup;
 
 extern QLibrary *loaded_curl_lib;
 
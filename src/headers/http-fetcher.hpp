@@ -0,0 +1,29 @@
+#pragma once
+#include <chrono>
+#include <string>
+
+// Fetches remote data in the background.
+//
+// All requests are performed on a single worker thread using a curl multi
+// handle, so connections are reused across requests and a slow server does not
+// block the switcher thread.
+// Requests for the same URL are coalesced and the responses are cached.
+// Cached data is revalidated using the ETag and Last-Modified headers, so
+// unchanged data does not have to be transferred again.
+class HttpFetcher {
+public:
+	struct Response {
+		std::string data;
+		// Increased whenever different data was received and 0 if no
+		// data was received yet
+		uint64_t version = 0;
+	};
+
+	// Returns the most recent data received for the URL and requests a
+	// refresh in the background if it is older than maxAge.
+	// The switcher thread is woken up once the data changes.
+	static Response Get(const std::string &url,
+			    std::chrono::milliseconds maxAge);
+	// Must be called before the curl library is unloaded
+	static void Stop();
+};
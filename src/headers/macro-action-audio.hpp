@@ -1,6 +1,7 @@
 #pragma once
 #include "macro-action-edit.hpp"
 #include "duration-control.hpp"
+#include "audio-fade.hpp"
 
 #include <QSpinBox>
 #include <QDoubleSpinBox>
@@ -36,6 +37,7 @@ public:
 	OBSWeakSource _audioSource;
 	AudioAction _action = AudioAction::MUTE;
 	FadeType _fadeType = FadeType::DURATION;
+	FadeCurve _fadeCurve = FadeCurve::LINEAR;
 	int _volume = 0;
 	bool _fade = false;
 	Duration _duration;
@@ -45,12 +47,7 @@ public:
 
 private:
 	void StartFade();
-	void FadeVolume();
-	void SetVolume(float vol);
-	float GetVolume();
-	void SetFadeActive(bool value);
-	bool FadeActive();
-	std::atomic_int *GetFadeIdPtr();
+	OBSWeakSource GetFadeTarget();
 
 	static bool _registered;
 	static const std::string id;
@@ -82,6 +79,7 @@ private slots:
 	void WaitChanged(int value);
 	void AbortActiveFadeChanged(int value);
 	void FadeTypeChanged(int value);
+	void FadeCurveChanged(int value);
 signals:
 	void HeaderInfoChanged(const QString &);
 
@@ -89,6 +87,7 @@ protected:
 	QComboBox *_audioSources;
 	QComboBox *_actions;
 	QComboBox *_fadeTypes;
+	QComboBox *_fadeCurves;
 	QSpinBox *_volumePercent;
 	QCheckBox *_fade;
 	DurationSelection *_duration;
@@ -96,6 +95,7 @@ protected:
 	QCheckBox *_wait;
 	QCheckBox *_abortActiveFade;
 	QHBoxLayout *_fadeTypeLayout;
+	QHBoxLayout *_fadeCurveLayout;
 	QVBoxLayout *_fadeOptionsLayout;
 	std::shared_ptr<MacroActionAudio> _entryData;
 
@@ -1,14 +1,24 @@
 #pragma once
 #include "macro.hpp"
 #include "volume-control.hpp"
+#include "audio-meter.hpp"
 #include <limits>
 #include <QWidget>
 #include <QComboBox>
+#include <QDoubleSpinBox>
+#include <QHBoxLayout>
 #include <chrono>
+#include <atomic>
 
 enum class AudioConditionCheckType {
 	OUTPUT_VOLUME,
 	CONFIGURED_VOLUME,
+	LOUDNESS,
+};
+
+enum class AudioLoudnessType {
+	RMS,
+	LUFS,
 };
 
 enum class AudioOutputCondition {
@@ -36,15 +46,14 @@ public:
 	bool Load(obs_data_t *obj);
 	std::string GetShortDesc();
 	std::string GetId() { return id; };
+	ConditionCost GetCost() { return ConditionCost::LOW; }
 	static std::shared_ptr<MacroCondition> Create(Macro *m)
 	{
 		return std::make_shared<MacroConditionAudio>(m);
 	}
-	static void SetVolumeLevel(void *data,
-				   const float magnitude[MAX_AUDIO_CHANNELS],
-				   const float peak[MAX_AUDIO_CHANNELS],
-				   const float inputPeak[MAX_AUDIO_CHANNELS]);
 	void ResetVolmeter();
+	WakeupEvent GetWakeupEvents();
+	bool HasCheckSideEffects();
 
 	OBSWeakSource _audioSource;
 	int _volume = 0;
@@ -52,13 +61,30 @@ public:
 		AudioConditionCheckType::OUTPUT_VOLUME;
 	AudioOutputCondition _outputCondition = AudioOutputCondition::ABOVE;
 	AudioVolumeCondition _volumeCondition = AudioVolumeCondition::ABOVE;
-	obs_volmeter_t *_volmeter = nullptr;
+	AudioLoudnessType _loudnessType = AudioLoudnessType::LUFS;
+	// Level in dBFS or LUFS
+	double _loudnessThreshold = -30.;
+	// Distance the level has to move back past the threshold before a
+	// match is no longer reported
+	double _hysteresis = 3.;
+	// Momentary loudness by default
+	int _window = 400;
+
+protected:
+	bool GetInputFingerprint(size_t &fingerprint);
 
 private:
 	bool CheckOutputCondition();
 	bool CheckVolumeCondition();
+	bool CheckLoudnessCondition();
+	void ReleaseMeter();
 
-	float _peak = -std::numeric_limits<float>::infinity();
+	std::shared_ptr<AudioMeter> _meter;
+	// Threshold registered with _meter to wake up the switcher thread or
+	// -1 if none is registered
+	int _wakeupThreshold = -1;
+	bool _loudnessEnabled = false;
+	bool _loudnessMatched = false;
 	static bool _registered;
 	static const std::string id;
 };
@@ -85,6 +111,10 @@ private slots:
 	void VolumeThresholdChanged(int vol);
 	void ConditionChanged(int cond);
 	void CheckTypeChanged(int cond);
+	void LoudnessTypeChanged(int type);
+	void LoudnessThresholdChanged(double value);
+	void HysteresisChanged(double value);
+	void WindowChanged(int value);
 
 signals:
 	void HeaderInfoChanged(const QString &);
@@ -94,6 +124,11 @@ protected:
 	QComboBox *_audioSources;
 	QComboBox *_condition;
 	QSpinBox *_volume;
+	QDoubleSpinBox *_loudnessThreshold;
+	QComboBox *_loudnessType;
+	QSpinBox *_window;
+	QDoubleSpinBox *_hysteresis;
+	QHBoxLayout *_loudnessLayout;
 	VolControl *_volMeter = nullptr;
 	std::shared_ptr<MacroConditionAudio> _entryData;
 
@@ -33,10 +33,13 @@ public:
 	bool Load(obs_data_t *obj);
 	std::string GetShortDesc();
 	std::string GetId() { return id; };
+	ConditionCost GetCost() { return ConditionCost::LOW; }
 	static std::shared_ptr<MacroCondition> Create(Macro *m)
 	{
 		return std::make_shared<MacroConditionDate>(m);
 	}
+	// Repeated dates are moved forward once they matched
+	bool HasCheckSideEffects() { return _repeat; }
 
 	void SetDate1(const QDate &date);
 	void SetDate2(const QDate &date);
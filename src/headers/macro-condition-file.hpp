@@ -2,10 +2,13 @@
 #include "macro.hpp"
 #include "file-selection.hpp"
 #include "resizing-text-edit.hpp"
+#include "duration-control.hpp"
 
 #include <QWidget>
 #include <QComboBox>
+#include <QHBoxLayout>
 #include <QDateTime>
+#include <QFileSystemWatcher>
 #include <QLineEdit>
 #include <QPushButton>
 #include <QCheckBox>
@@ -17,16 +20,21 @@ enum class FileType {
 
 class MacroConditionFile : public MacroCondition {
 public:
-	MacroConditionFile(Macro *m) : MacroCondition(m) {}
+	MacroConditionFile(Macro *m);
 	bool CheckCondition();
 	bool Save(obs_data_t *obj);
 	bool Load(obs_data_t *obj);
 	std::string GetShortDesc();
 	std::string GetId() { return id; };
+	ConditionCost GetCost();
+	bool CanBeCheckedConcurrently();
 	static std::shared_ptr<MacroCondition> Create(Macro *m)
 	{
 		return std::make_shared<MacroConditionFile>(m);
 	}
+	WakeupEvent GetWakeupEvents();
+	bool HasCheckSideEffects();
+	void UpdateFileWatcher();
 
 	std::string _file = obs_module_text("AdvSceneSwitcher.enterPath");
 	std::string _text = obs_module_text("AdvSceneSwitcher.enterText");
@@ -34,14 +42,21 @@ public:
 	bool _useRegex = false;
 	bool _useTime = false;
 	bool _onlyMatchIfChanged = false;
+	// Maximum age of the remote data before it is fetched again
+	Duration _refreshInterval;
+
+protected:
+	bool GetInputFingerprint(size_t &fingerprint);
 
 private:
 	bool matchFileContent(QString &filedata);
 	bool checkRemoteFileContent();
+	std::chrono::milliseconds getRefreshInterval();
 	bool checkLocalFileContent();
 
 	QDateTime _lastMod;
 	size_t _lastHash = 0;
+	QFileSystemWatcher _watcher;
 	static bool _registered;
 	static const std::string id;
 };
@@ -69,6 +84,8 @@ private slots:
 	void UseRegexChanged(int state);
 	void CheckModificationDateChanged(int state);
 	void OnlyMatchIfChangedChanged(int state);
+	void RefreshIntervalChanged(double seconds);
+	void RefreshIntervalUnitChanged(DurationUnit unit);
 signals:
 	void HeaderInfoChanged(const QString &);
 
@@ -79,8 +96,12 @@ protected:
 	QCheckBox *_useRegex;
 	QCheckBox *_checkModificationDate;
 	QCheckBox *_checkFileContent;
+	DurationSelection *_refreshInterval;
 	std::shared_ptr<MacroConditionFile> _entryData;
 
 private:
+	void SetWidgetVisibility();
+
+	QHBoxLayout *_refreshIntervalLayout;
 	bool _loading = true;
 };
@@ -11,10 +11,12 @@ public:
 	bool Save(obs_data_t *obj);
 	bool Load(obs_data_t *obj);
 	std::string GetId() { return id; };
+	ConditionCost GetCost() { return ConditionCost::LOW; }
 	static std::shared_ptr<MacroCondition> Create(Macro *m)
 	{
 		return std::make_shared<MacroConditionHotkey>(m);
 	}
+	bool HasCheckSideEffects() { return true; }
 	void SetPressed() { _pressed = true; }
 
 	std::string _name;
@@ -12,6 +12,7 @@ public:
 	bool Save(obs_data_t *obj);
 	bool Load(obs_data_t *obj);
 	std::string GetId() { return id; };
+	bool CanBeCheckedConcurrently() { return false; }
 	static std::shared_ptr<MacroCondition> Create(Macro *m)
 	{
 		return std::make_shared<MacroConditionIdle>(m);
@@ -27,6 +27,7 @@ public:
 	bool Load(obs_data_t *obj);
 	std::string GetShortDesc();
 	std::string GetId() { return id; };
+	ConditionCost GetCost() { return ConditionCost::LOW; }
 	static std::shared_ptr<MacroCondition> Create(Macro *m)
 	{
 		return std::make_shared<MacroConditionMacro>(m);
@@ -50,6 +50,7 @@ public:
 	bool Load(obs_data_t *obj);
 	std::string GetShortDesc();
 	std::string GetId() { return id; };
+	ConditionCost GetCost() { return ConditionCost::LOW; }
 	static std::shared_ptr<MacroCondition> Create(Macro *m)
 	{
 		return std::make_shared<MacroConditionMedia>(m);
@@ -59,6 +60,8 @@ public:
 	static void MediaStopped(void *data, calldata_t *);
 	static void MediaEnded(void *data, calldata_t *);
 	static void MediaNext(void *data, calldata_t *);
+	WakeupEvent GetWakeupEvents() { return WakeupEvent::MEDIA_STATE; }
+	bool HasCheckSideEffects() { return true; }
 
 	MediaSourceType _sourceType = MediaSourceType::SOURCE;
 	SceneSelection _scene;
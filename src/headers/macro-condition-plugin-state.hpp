@@ -17,6 +17,11 @@ public:
 	bool Save(obs_data_t *obj);
 	bool Load(obs_data_t *obj);
 	std::string GetId() { return id; };
+	ConditionCost GetCost() { return ConditionCost::LOW; }
+	bool DependsOnPreviousMacros()
+	{
+		return _condition == PluginStateCondition::SCENE_SWITCHED;
+	}
 	static std::shared_ptr<MacroCondition> Create(Macro *m)
 	{
 		return std::make_shared<MacroConditionPluginState>(m);
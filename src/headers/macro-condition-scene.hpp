@@ -21,10 +21,14 @@ public:
 	bool Load(obs_data_t *obj);
 	std::string GetShortDesc();
 	std::string GetId() { return id; };
+	ConditionCost GetCost() { return ConditionCost::LOW; }
 	static std::shared_ptr<MacroCondition> Create(Macro *m)
 	{
 		return std::make_shared<MacroConditionScene>(m);
 	}
+	WakeupEvent GetWakeupEvents();
+	bool RequiresPolling();
+	bool HasCheckSideEffects();
 
 	SceneSelection _scene;
 	SceneType _type = SceneType::CURRENT;
@@ -33,6 +37,9 @@ public:
 	// from.
 	bool _useTransitionTargetScene = false;
 
+protected:
+	bool GetInputFingerprint(size_t &fingerprint);
+
 private:
 	std::chrono::high_resolution_clock::time_point _lastSceneChangeTime{};
 	static bool _registered;
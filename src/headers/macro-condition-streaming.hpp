@@ -17,10 +17,12 @@ public:
 	bool Save(obs_data_t *obj);
 	bool Load(obs_data_t *obj);
 	std::string GetId() { return id; };
+	ConditionCost GetCost() { return ConditionCost::LOW; }
 	static std::shared_ptr<MacroCondition> Create(Macro *m)
 	{
 		return std::make_shared<MacroConditionStream>(m);
 	}
+	bool HasCheckSideEffects() { return true; }
 
 	StreamState _streamState = StreamState::STOP;
 
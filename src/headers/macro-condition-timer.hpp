@@ -22,10 +22,12 @@ public:
 	bool Save(obs_data_t *obj);
 	bool Load(obs_data_t *obj);
 	std::string GetId() { return id; };
+	ConditionCost GetCost() { return ConditionCost::LOW; }
 	static std::shared_ptr<MacroCondition> Create(Macro *m)
 	{
 		return std::make_shared<MacroConditionTimer>(m);
 	}
+	bool HasCheckSideEffects() { return true; }
 	void Pause();
 	void Continue();
 	void Reset();
@@ -24,12 +24,16 @@ public:
 	bool Load(obs_data_t *obj);
 	std::string GetShortDesc();
 	std::string GetId() { return id; };
+	ConditionCost GetCost() { return ConditionCost::LOW; }
 	static std::shared_ptr<MacroCondition> Create(Macro *m)
 	{
 		return std::make_shared<MacroConditionTransition>(m);
 	}
 	void ConnectToTransitionSignals();
 	void DisconnectTransitionSignals();
+	WakeupEvent GetWakeupEvents();
+	bool RequiresPolling();
+	bool HasCheckSideEffects() { return true; }
 
 	TransitionCondition _condition = TransitionCondition::CURRENT;
 	TransitionSelection _transition;
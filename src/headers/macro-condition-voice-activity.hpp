@@ -0,0 +1,74 @@
+#pragma once
+#include "macro.hpp"
+#include "voice-activity.hpp"
+
+#include <QWidget>
+#include <QComboBox>
+#include <QSpinBox>
+
+class MacroConditionVoiceActivity : public MacroCondition {
+public:
+	MacroConditionVoiceActivity(Macro *m) : MacroCondition(m) {}
+	bool CheckCondition();
+	bool Save(obs_data_t *obj);
+	bool Load(obs_data_t *obj);
+	std::string GetShortDesc();
+	std::string GetId() { return id; };
+	ConditionCost GetCost() { return ConditionCost::LOW; }
+	WakeupEvent GetWakeupEvents() { return WakeupEvent::AUDIO_LEVEL; }
+	static std::shared_ptr<MacroCondition> Create(Macro *m)
+	{
+		return std::make_shared<MacroConditionVoiceActivity>(m);
+	}
+	void ResetDetector();
+
+	enum class State {
+		SPEAKING,
+		SILENT,
+	};
+
+	OBSWeakSource _audioSource;
+	State _state = State::SPEAKING;
+	// Minimum time in ms the source has to stay in the selected state
+	int _duration = 0;
+
+private:
+	std::shared_ptr<VoiceActivityDetector> _detector;
+	static bool _registered;
+	static const std::string id;
+};
+
+class MacroConditionVoiceActivityEdit : public QWidget {
+	Q_OBJECT
+
+public:
+	MacroConditionVoiceActivityEdit(
+		QWidget *parent,
+		std::shared_ptr<MacroConditionVoiceActivity> cond = nullptr);
+	void UpdateEntryData();
+	static QWidget *Create(QWidget *parent,
+			       std::shared_ptr<MacroCondition> cond)
+	{
+		return new MacroConditionVoiceActivityEdit(
+			parent,
+			std::dynamic_pointer_cast<MacroConditionVoiceActivity>(
+				cond));
+	}
+
+private slots:
+	void SourceChanged(const QString &text);
+	void StateChanged(int state);
+	void DurationChanged(int duration);
+
+signals:
+	void HeaderInfoChanged(const QString &);
+
+protected:
+	QComboBox *_audioSources;
+	QComboBox *_states;
+	QSpinBox *_duration;
+	std::shared_ptr<MacroConditionVoiceActivity> _entryData;
+
+private:
+	bool _loading = true;
+};
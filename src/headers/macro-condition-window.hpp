@@ -12,6 +12,10 @@ public:
 	bool Load(obs_data_t *obj);
 	std::string GetShortDesc();
 	std::string GetId() { return id; };
+	ConditionCost GetCost() { return ConditionCost::HIGH; }
+	bool CanBeCheckedConcurrently() { return false; }
+	WakeupEvent GetWakeupEvents() { return WakeupEvent::WINDOW_CHANGE; }
+	bool RequiresPolling();
 	static std::shared_ptr<MacroCondition> Create(Macro *m)
 	{
 		return std::make_shared<MacroConditionWindow>(m);
@@ -19,8 +23,9 @@ public:
 
 private:
 	bool CheckWindowTitleSwitchDirect(std::string &currentWindowTitle);
-	bool CheckWindowTitleSwitchRegex(std::string &currentWindowTitle,
-					 std::vector<std::string> &windowList);
+	bool
+	CheckWindowTitleSwitchRegex(std::string &currentWindowTitle,
+				    const std::vector<std::string> &windowList);
 
 public:
 	std::string _window;
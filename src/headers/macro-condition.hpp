@@ -2,30 +2,36 @@
 #include "macro-segment.hpp"
 #include "macro-ref.hpp"
 #include "duration-control.hpp"
+#include "condition-logic.hpp"
 
-constexpr auto logic_root_offset = 100;
+struct LogicTypeInfo {
+	std::string _name;
+};
 
-enum class LogicType {
-	ROOT_NONE = 0,
-	ROOT_NOT,
-	ROOT_LAST,
-	// leave some space for potential expansion
-	NONE = 100,
-	AND,
-	OR,
-	AND_NOT,
-	OR_NOT,
-	LAST,
+// Events which can change the state of a condition.
+// If any of the events a condition depends on occurs the switcher thread will
+// be woken up immediately instead of waiting for the check interval to pass.
+enum class WakeupEvent : uint32_t {
+	NONE = 0,
+	SCENE_CHANGE = 1 << 0,
+	TRANSITION = 1 << 1,
+	MEDIA_STATE = 1 << 2,
+	AUDIO_LEVEL = 1 << 3,
+	FILE_CHANGE = 1 << 4,
+	WINDOW_CHANGE = 1 << 5,
+	ALL = 0xFFFFFFFF,
 };
 
-static inline bool isRootLogicType(LogicType l)
+static inline WakeupEvent operator|(WakeupEvent a, WakeupEvent b)
 {
-	return static_cast<int>(l) < logic_root_offset;
+	return static_cast<WakeupEvent>(static_cast<uint32_t>(a) |
+					 static_cast<uint32_t>(b));
 }
 
-struct LogicTypeInfo {
-	std::string _name;
-};
+static inline bool hasWakeupEvent(WakeupEvent events, WakeupEvent e)
+{
+	return (static_cast<uint32_t>(events) & static_cast<uint32_t>(e)) != 0;
+}
 
 class DurationModifier {
 public:
@@ -65,6 +71,9 @@ public:
 	virtual bool CheckCondition() = 0;
 	virtual bool Save(obs_data_t *obj) = 0;
 	virtual bool Load(obs_data_t *obj) = 0;
+	// Only calls CheckCondition() if the inputs of this condition changed
+	// since the last check and returns the previous result otherwise
+	bool CheckConditionCached();
 	LogicType GetLogicType() { return _logic; }
 	void SetLogicType(LogicType logic) { _logic = logic; }
 	static const std::map<LogicType, LogicTypeInfo> logicTypes;
@@ -75,9 +84,36 @@ public:
 	void SetDurationUnit(DurationUnit u);
 	void SetDuration(double seconds);
 
+	// Used to decide the order in which conditions are checked
+	virtual ConditionCost GetCost() { return ConditionCost::MEDIUM; }
+	// Return false if this condition must not be checked while conditions
+	// of other macros are checked on other threads
+	virtual bool CanBeCheckedConcurrently() { return true; }
+	// Return true if the result of this condition depends on the results
+	// of the macros checked before it
+	virtual bool DependsOnPreviousMacros() { return false; }
+	// Events after which this condition should be checked again
+	virtual WakeupEvent GetWakeupEvents() { return WakeupEvent::NONE; }
+	// Returns false if the state of this condition can only change due to
+	// the events returned by GetWakeupEvents()
+	virtual bool RequiresPolling() { return true; }
+	// Return true if CheckCondition() updates state later checks rely on,
+	// so the check must not be skipped even if its result is not needed
+	virtual bool HasCheckSideEffects() { return false; }
+
+protected:
+	// Combine the current state of all inputs of this condition including
+	// its settings into the given fingerprint.
+	// Return false if the result of this condition cannot be cached.
+	virtual bool GetInputFingerprint(size_t &) { return false; }
+
 private:
 	LogicType _logic = LogicType::ROOT_NONE;
 	DurationModifier _duration;
+
+	bool _cacheValid = false;
+	size_t _lastFingerprint = 0;
+	bool _lastResult = false;
 };
 
 class MacroRefCondition : public MacroCondition {
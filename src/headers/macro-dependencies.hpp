@@ -0,0 +1,22 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+struct MacroDependencies {
+	// Indices of the macros this macro refers to
+	std::vector<size_t> macros;
+	// The macro depends on all macros checked before it
+	bool previousMacros = false;
+
+	bool operator==(const MacroDependencies &other) const
+	{
+		return macros == other.macros &&
+		       previousMacros == other.previousMacros;
+	}
+};
+
+// Assigns each macro a level, so that a macro only depends on macros of lower
+// levels and all macros of the same level can be checked independently.
+// Cyclic dependencies cannot be resolved and are ignored.
+std::vector<int>
+getMacroCheckLevels(const std::vector<MacroDependencies> &dependencies);
@@ -15,6 +15,9 @@ public:
 	bool _highlightExecuted = false;
 	bool _highlightConditions = false;
 	bool _highlightActions = false;
+	bool _shortCircuitEvaluation = false;
+	bool _reorderConditions = false;
+	bool _concurrentEvaluation = false;
 };
 
 // Dialog for configuring global and macro specific settings
@@ -31,5 +34,8 @@ private:
 	QCheckBox *_executed;
 	QCheckBox *_conditions;
 	QCheckBox *_actions;
+	QCheckBox *_shortCircuit;
+	QCheckBox *_reorder;
+	QCheckBox *_concurrent;
 	QCheckBox *_hotkeys;
 };
@@ -32,6 +32,11 @@ public:
 	bool Paused() { return _paused; }
 	void SetMatchOnChange(bool onChange) { _matchOnChange = onChange; }
 	bool MatchOnChange() { return _matchOnChange; }
+	WakeupEvent GetWakeupEvents();
+	bool RequiresPolling();
+	bool CanBeCheckedConcurrently();
+	bool DependsOnPreviousMacros();
+	std::vector<Macro *> GetReferencedMacros();
 	int GetCount() { return _count; };
 	void ResetCount() { _count = 0; };
 	void AddHelperThread(std::thread &&);
@@ -90,6 +95,7 @@ private:
 	bool _onChangeTriggered = false;
 
 	std::chrono::high_resolution_clock::time_point _lastCheckTime{};
+	ConditionLogicChain _logicChain;
 
 	bool _die = false;
 	bool _stop = false;
@@ -10,6 +10,9 @@ std::pair<int, int> getCursorPos();
 int secondsSinceLastInput();
 void GetProcessList(QStringList &processes);
 bool isInFocus(const QString &executable);
+// Returns true if changes of the windows are reported via NotifyWindowChange()
+bool WindowChangeEventsSupported();
+void NotifyWindowChange();
 void PressKeys(const std::vector<HotkeyType> keys, int duration);
 void PlatformInit();
 void PlatformCleanup();
@@ -0,0 +1,35 @@
+#pragma once
+#include <QDockWidget>
+#include <QCheckBox>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QTimer>
+
+class ProfilerWidget : public QWidget {
+	Q_OBJECT
+
+public:
+	ProfilerWidget(QWidget *parent = 0);
+
+private slots:
+	void EnableChanged(int state);
+	void ResetClicked();
+	void ExportClicked();
+	void UpdateTable();
+
+private:
+	QCheckBox *_enable;
+	QPushButton *_reset;
+	QPushButton *_export;
+	QTableWidget *_table;
+	QTimer _timer;
+};
+
+class ProfilerDock : public QDockWidget {
+	Q_OBJECT
+
+public:
+	ProfilerDock(QWidget *parent = 0);
+};
+
+void SetupProfilerDock();
@@ -0,0 +1,73 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+constexpr auto profiler_window_size = 500;
+
+enum class ProfilerCategory {
+	TICK,
+	LOCK_WAIT,
+	CONDITION,
+	ACTION,
+	LEGACY_SWITCH,
+};
+
+struct ProfilerStats {
+	size_t count = 0;
+	double p50 = 0.;
+	double p95 = 0.;
+	double max = 0.;
+};
+
+// Keeps the most recent duration measurements in milliseconds
+class ProfilerSampleWindow {
+public:
+	void Add(double ms);
+	ProfilerStats GetStats() const;
+
+private:
+	std::vector<double> _samples;
+	size_t _next = 0;
+	size_t _count = 0;
+};
+
+// Collects duration measurements of conditions, actions and the switcher
+// thread itself.
+// Samples can be added from multiple threads.
+class Profiler {
+public:
+	struct Entry {
+		ProfilerCategory category;
+		std::string name;
+		ProfilerStats stats;
+	};
+
+	void SetEnabled(bool enable) { _enabled = enable; }
+	bool Enabled() const { return _enabled; }
+	void AddSample(ProfilerCategory category, const std::string &name,
+		       double ms);
+	void Reset();
+	std::vector<Entry> GetEntries();
+	std::string ToCSV();
+	std::string ToJSON();
+
+private:
+	std::atomic_bool _enabled = {false};
+	std::mutex _mutex;
+	std::map<std::pair<ProfilerCategory, std::string>, ProfilerSampleWindow>
+		_windows;
+};
+
+const char *getProfilerCategoryName(ProfilerCategory category);
+
+static inline double
+msSince(const std::chrono::high_resolution_clock::time_point &start)
+{
+	return std::chrono::duration<double, std::milli>(
+		       std::chrono::high_resolution_clock::now() - start)
+		.count();
+}
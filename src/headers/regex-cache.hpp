@@ -0,0 +1,20 @@
+#pragma once
+#include <QRegularExpression>
+#include <QStringList>
+#include <string>
+
+// Returns the compiled and optimized regular expression for the given pattern.
+//
+// Compiled expressions are cached, so this can be called each interval.
+// If fullMatch is set the expression only matches if the whole string matches
+// the pattern, like std::regex_match() does.
+// The returned expression is not valid if the pattern could not be compiled.
+QRegularExpression getRegex(const QString &pattern, bool fullMatch = false);
+
+// Returns true if the whole string matches the pattern.
+// Invalid patterns never match.
+bool matchRegex(const std::string &str, const std::string &pattern);
+
+// Returns true if any string of the list matches the pattern as a whole.
+// Unlike QStringList::indexOf() this uses the cached expression.
+bool containsRegexMatch(const QStringList &list, const QString &pattern);
@@ -0,0 +1,86 @@
+#pragma once
+#include <obs.hpp>
+#include <QImage>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+struct CaptureSettings {
+	// Area of the source to capture - the whole source is captured if
+	// the area is empty
+	int x = 0;
+	int y = 0;
+	int width = 0;
+	int height = 0;
+	// Factor applied to the captured area before downloading it
+	double scale = 1.;
+
+	bool operator<(const CaptureSettings &other) const
+	{
+		return std::tie(x, y, width, height, scale) <
+		       std::tie(other.x, other.y, other.width, other.height,
+				other.scale);
+	}
+	bool operator!=(const CaptureSettings &other) const
+	{
+		return *this < other || other < *this;
+	}
+};
+
+// Captures the video output of a source or of the main OBS output on request.
+//
+// All users of the same source and capture settings share a single capture,
+// which keeps its graphics resources and frame buffers alive as long as it is
+// in use.
+// Only the requested area is rendered and it is scaled on the GPU, so only
+// the data which is actually needed has to be downloaded.
+// Two stage surfaces are used, so a new capture can already be staged while
+// the previous one is still being downloaded.
+class SourceCapture {
+public:
+	struct Frame {
+		QImage image;
+		// Increased for each captured frame and 0 if no frame was
+		// captured yet
+		uint64_t sequence = 0;
+		std::chrono::high_resolution_clock::time_point time;
+	};
+
+	// Pass nullptr to capture the main OBS output
+	static std::shared_ptr<SourceCapture>
+	Get(const OBSWeakSource &source, const CaptureSettings &settings = {});
+	~SourceCapture();
+
+	OBSWeakSource GetSource() const { return _source; }
+	const CaptureSettings &GetSettings() const { return _settings; }
+	// Captures a new frame within the next video frames
+	void Request() { _requested = true; }
+	Frame GetFrame();
+
+private:
+	SourceCapture(const OBSWeakSource &source,
+		      const CaptureSettings &settings);
+	static void Tick(void *param, float);
+	bool Render();
+	void Copy(gs_stagesurf_t *surface);
+	void PublishFrame(QImage &image);
+
+	OBSWeakSource _source;
+	CaptureSettings _settings;
+	std::atomic_bool _requested = {false};
+
+	// Only accessed from within the tick callback
+	gs_texrender_t *_texrender = nullptr;
+	gs_stagesurf_t *_stagesurfs[2] = {nullptr, nullptr};
+	int _nextSurface = 0;
+	int _pendingSurface = -1;
+	uint32_t _cx = 0;
+	uint32_t _cy = 0;
+	QImage _buffers[2];
+	int _nextBuffer = 0;
+
+	std::mutex _mutex;
+	Frame _frame;
+};
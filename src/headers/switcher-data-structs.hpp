@@ -5,6 +5,9 @@
 #include <mutex>
 #include <QDateTime>
 #include <QThread>
+#include <QThreadPool>
+#include <QSet>
+#include <QStringList>
 #include <curl/curl.h>
 #include <unordered_map>
 
@@ -26,10 +29,17 @@
 #include "switch-network.hpp"
 
 #include "macro.hpp"
+#include "macro-dependencies.hpp"
 #include "macro-properties.hpp"
 #include "duration-control.hpp"
+#include "profiler.hpp"
 
 constexpr auto default_interval = 300;
+// Maximum time to sleep if no condition needs to be polled
+constexpr auto event_driven_fallback_interval = 5000;
+// Minimum time between checks triggered by events, so a burst of events only
+// results in a single check
+constexpr auto min_wakeup_interval = 50;
 constexpr auto previous_scene_name = "Previous Scene";
 constexpr auto current_transition_name = "Current Transition";
 constexpr auto tab_count = 18;
@@ -83,6 +93,14 @@ struct SwitcherData {
 
 	std::condition_variable cv;
 	std::mutex m;
+	Profiler profiler;
+	// Wakeups use their own mutex, as events are also reported from
+	// threads which must not wait for the checks holding m to finish
+	std::condition_variable wakeupCv;
+	std::mutex wakeupMutex;
+	bool wakeup = false;
+	std::atomic<WakeupEvent> wakeupEvents = {WakeupEvent::ALL};
+	bool pollingRequired = true;
 	bool transitionActive = false;
 	bool waitForTransition = false;
 	bool stop = false;
@@ -111,13 +129,6 @@ struct SwitcherData {
 	StartupBehavior startupBehavior = PERSIST;
 	AutoStartEvent autoStartEvent = AutoStartEvent::NEVER;
 
-	struct AudioFadeInfo {
-		std::atomic_bool active = {false};
-		std::atomic_int id = {0};
-	};
-	AudioFadeInfo masterAudioFade;
-	std::unordered_map<std::string, AudioFadeInfo> activeAudioFades;
-
 	Duration cooldown;
 	std::chrono::high_resolution_clock::time_point lastMatchTime;
 
@@ -126,6 +137,10 @@ struct SwitcherData {
 	std::condition_variable macroWaitCv;
 	std::atomic_bool abortMacroWait = {false};
 	std::condition_variable macroTransitionCv;
+	QThreadPool macroThreadPool;
+	// Only recomputed once the dependencies between the macros change
+	std::vector<MacroDependencies> macroDependencies;
+	std::vector<int> macroCheckLevels;
 	bool macroSceneSwitched = false;
 	bool replayBufferSaved = false;
 	bool obsIsShuttingDown = false;
@@ -135,6 +150,9 @@ struct SwitcherData {
 	std::vector<std::string> ignoreIdleWindows;
 	std::string lastTitle;
 	std::string currentTitle;
+	// Only queried once per interval and only if it is actually needed
+	std::vector<std::string> windowList;
+	bool windowListValid = false;
 
 	std::deque<ScreenRegionSwitch> screenRegionSwitches;
 	std::pair<int, int> lastCursorPos = {0, 0};
@@ -154,6 +172,10 @@ struct SwitcherData {
 	CURL *curl = nullptr;
 
 	std::deque<ExecutableSwitch> executableSwitches;
+	// Only queried once per interval and only if it is actually needed
+	QStringList processList;
+	QSet<QString> processNames;
+	bool processListValid = false;
 
 	std::deque<SceneTrigger> sceneTriggers;
 
@@ -232,6 +254,14 @@ struct SwitcherData {
 	void Thread();
 	void Start();
 	void Stop();
+	void Wakeup(WakeupEvent event = WakeupEvent::ALL);
+
+	void updateWakeupEvents();
+	void waitForWakeup(
+		std::chrono::milliseconds duration,
+		std::chrono::high_resolution_clock::time_point earliestCheck);
+	void clearWakeup();
+	bool legacySwitchesConfigured();
 
 	void setWaitScene();
 	bool sceneChangedDuringWait();
@@ -246,10 +276,15 @@ struct SwitcherData {
 	void writeToStatusFile(const QString &msg);
 
 	void setPreconditions();
+	const std::vector<std::string> &getWindowList();
+	const QStringList &getProcessList();
+	bool isProcessRunning(const QString &name);
 	bool checkForMatch(OBSWeakSource &scene, OBSWeakSource &transition,
 			   int &linger, bool &setPreviousSceneAsMatch,
 			   bool &macroMatch);
 	bool checkMacros();
+	bool checkMacrosConcurrently();
+	const std::vector<int> &getMacroCheckLevels();
 	bool runMacros();
 	bool checkSceneSequence(OBSWeakSource &scene, OBSWeakSource &transition,
 				int &linger, bool &setPrevSceneAfterLinger);
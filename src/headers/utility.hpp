@@ -84,3 +84,4 @@ void populateSourceGroupSelection(QComboBox *list);
 void populateProfileSelection(QComboBox *list);
 bool windowPosValid(QPoint pos);
 bool doubleEquals(double left, double right, double epsilon);
+void hashCombine(size_t &seed, size_t value);
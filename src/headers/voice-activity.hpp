@@ -0,0 +1,62 @@
+#pragma once
+#include <obs.hpp>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+// Detects whether someone is speaking on an audio source.
+//
+// The audio callback only downmixes the audio data and pushes it into a lock
+// free sample buffer.
+// The actual detection is done in 10 ms frames on a single worker thread shared
+// by all detectors, so the detection lags behind the audio by at most a few
+// frames regardless of the switcher's check interval.
+//
+// Each frame is classified using its energy relative to an adaptive noise floor
+// and its zero-crossing rate.
+// Speech is only reported once most of the recent frames were classified as
+// speech, which filters out short impulses like keyboard clicks, and it is kept
+// for a short hangover period to bridge the pauses between words.
+//
+// All users of the same source share a single detector.
+class VoiceActivityDetector {
+public:
+	static std::shared_ptr<VoiceActivityDetector>
+	Get(const OBSWeakSource &source);
+	~VoiceActivityDetector();
+
+	OBSWeakSource GetSource() const { return _source; }
+	bool IsSpeaking() const { return _speaking; }
+	// Time passed since the last change between speaking and silence
+	std::chrono::milliseconds GetStateDuration() const;
+
+private:
+	VoiceActivityDetector(const OBSWeakSource &source);
+	static void ProcessAudio(void *data, obs_source_t *source,
+				 const struct audio_data *audio, bool muted);
+	static void RunWorker(std::shared_ptr<bool> stop);
+	void Process();
+	void ProcessFrame();
+	void SetSpeaking(bool speaking);
+
+	OBSWeakSource _source;
+
+	// Mono samples passed from the audio callback to the worker thread
+	static constexpr size_t _bufferSize = 1 << 16;
+	float _samples[_bufferSize];
+	std::atomic<size_t> _writePos = {0};
+	std::atomic<size_t> _readPos = {0};
+	std::atomic<uint32_t> _sampleRate = {0};
+
+	// Only accessed from the worker thread
+	std::vector<float> _frame;
+	size_t _frameFill = 0;
+	double _noiseFloor = 0.;
+	bool _noiseFloorValid = false;
+	uint32_t _recentFrames = 0;
+	int _hangover = 0;
+
+	std::atomic_bool _speaking = {false};
+	std::atomic<int64_t> _stateChangeTime;
+};
@@ -0,0 +1,305 @@
+#include "headers/http-fetcher.hpp"
+#include "headers/curl-helper.hpp"
+#include "headers/advanced-scene-switcher.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Requests no longer block the switcher thread, so slow servers can be given
+// more time to respond
+constexpr long requestTimeout = 10;
+// Time to wait for network activity before checking for new requests
+constexpr int pollTimeout = 50;
+// Cached data which was not requested for this long is dropped
+constexpr auto cacheExpiry = std::chrono::minutes(5);
+
+namespace {
+
+struct CacheEntry {
+	std::string data;
+	uint64_t version = 0;
+	std::string etag;
+	std::string lastModified;
+	bool fetched = false;
+	// Set while a request for the URL is queued or in progress
+	bool pending = false;
+	std::chrono::high_resolution_clock::time_point fetchTime;
+	std::chrono::high_resolution_clock::time_point lastAccess;
+};
+
+struct Transfer {
+	~Transfer()
+	{
+		f_curl_slist_free_all(headers);
+		f_curl_cleanup(handle);
+	}
+
+	std::string url;
+	std::string body;
+	std::string etag;
+	std::string lastModified;
+	CURL *handle = nullptr;
+	struct curl_slist *headers = nullptr;
+};
+
+} // namespace
+
+static std::mutex cacheMutex;
+static std::map<std::string, CacheEntry> cache;
+static std::vector<std::string> queue;
+// Signaled once requests are queued, so the worker can block while idle
+static std::condition_variable queueCV;
+static std::thread worker;
+static std::atomic_bool stopWorker = {false};
+
+static size_t writeCallback(void *contents, size_t size, size_t nmemb,
+			    void *userp)
+{
+	((std::string *)userp)->append((char *)contents, size * nmemb);
+	return size * nmemb;
+}
+
+static bool parseHeader(const std::string &line, const std::string &name,
+			std::string &value)
+{
+	if (line.size() <= name.size() || line[name.size()] != ':') {
+		return false;
+	}
+	for (size_t i = 0; i < name.size(); i++) {
+		if (std::tolower((unsigned char)line[i]) != name[i]) {
+			return false;
+		}
+	}
+
+	size_t start = line.find_first_not_of(" \t", name.size() + 1);
+	size_t end = line.find_last_not_of(" \t\r\n");
+	if (start == std::string::npos || end < start) {
+		value.clear();
+	} else {
+		value = line.substr(start, end - start + 1);
+	}
+	return true;
+}
+
+static size_t headerCallback(char *buffer, size_t size, size_t nitems,
+			     void *userp)
+{
+	auto transfer = static_cast<Transfer *>(userp);
+	std::string line(buffer, size * nitems);
+
+	// Only keep the headers of the final response after redirects
+	if (line.compare(0, 5, "HTTP/") == 0) {
+		transfer->etag.clear();
+		transfer->lastModified.clear();
+		return size * nitems;
+	}
+
+	if (!parseHeader(line, "etag", transfer->etag)) {
+		parseHeader(line, "last-modified", transfer->lastModified);
+	}
+	return size * nitems;
+}
+
+static std::unique_ptr<Transfer> createTransfer(const std::string &url)
+{
+	auto transfer = std::make_unique<Transfer>();
+	transfer->url = url;
+	{
+		std::lock_guard<std::mutex> lock(cacheMutex);
+		auto &entry = cache[url];
+		if (!entry.etag.empty()) {
+			transfer->headers = f_curl_slist_append(
+				transfer->headers,
+				("If-None-Match: " + entry.etag).c_str());
+		}
+		if (!entry.lastModified.empty()) {
+			transfer->headers = f_curl_slist_append(
+				transfer->headers,
+				("If-Modified-Since: " + entry.lastModified)
+					.c_str());
+		}
+	}
+
+	transfer->handle = f_curl_init();
+	CURL *handle = transfer->handle;
+	f_curl_setopt(handle, CURLOPT_URL, transfer->url.c_str());
+	f_curl_setopt(handle, CURLOPT_WRITEFUNCTION, writeCallback);
+	f_curl_setopt(handle, CURLOPT_WRITEDATA, &transfer->body);
+	f_curl_setopt(handle, CURLOPT_HEADERFUNCTION, headerCallback);
+	f_curl_setopt(handle, CURLOPT_HEADERDATA, transfer.get());
+	f_curl_setopt(handle, CURLOPT_HTTPHEADER, transfer->headers);
+	f_curl_setopt(handle, CURLOPT_TIMEOUT, requestTimeout);
+	f_curl_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+	f_curl_setopt(handle, CURLOPT_PRIVATE, transfer.get());
+	return transfer;
+}
+
+static void startQueuedTransfers(CURLM *multi,
+				 std::vector<std::unique_ptr<Transfer>> &active)
+{
+	std::vector<std::string> urls;
+	{
+		std::lock_guard<std::mutex> lock(cacheMutex);
+		urls.swap(queue);
+
+		const auto now = std::chrono::high_resolution_clock::now();
+		for (auto it = cache.begin(); it != cache.end();) {
+			if (!it->second.pending &&
+			    now - it->second.lastAccess > cacheExpiry) {
+				it = cache.erase(it);
+			} else {
+				++it;
+			}
+		}
+	}
+
+	for (const auto &url : urls) {
+		auto transfer = createTransfer(url);
+		f_curl_multi_add_handle(multi, transfer->handle);
+		active.emplace_back(std::move(transfer));
+	}
+}
+
+static void finishTransfers(CURLM *multi,
+			    std::vector<std::unique_ptr<Transfer>> &active)
+{
+	CURLMsg *msg;
+	int remaining = 0;
+	while ((msg = f_curl_multi_info_read(multi, &remaining))) {
+		if (msg->msg != CURLMSG_DONE) {
+			continue;
+		}
+
+		Transfer *transfer = nullptr;
+		f_curl_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &transfer);
+		long code = 0;
+		f_curl_getinfo(msg->easy_handle, CURLINFO_RESPONSE_CODE, &code);
+		const bool success = msg->data.result == CURLE_OK;
+
+		bool changed = false;
+		{
+			std::lock_guard<std::mutex> lock(cacheMutex);
+			auto &entry = cache[transfer->url];
+			entry.pending = false;
+			entry.fetched = true;
+			entry.fetchTime =
+				std::chrono::high_resolution_clock::now();
+
+			// Unchanged data (304) and failed requests keep the
+			// previously received data
+			if (success && code != 304) {
+				if (entry.version == 0 ||
+				    entry.data != transfer->body) {
+					entry.data = std::move(transfer->body);
+					entry.version++;
+					changed = true;
+				}
+				entry.etag = transfer->etag;
+				entry.lastModified = transfer->lastModified;
+			}
+		}
+
+		if (!success) {
+			vblog(LOG_INFO, "failed to fetch \"%s\" (%d)",
+			      transfer->url.c_str(),
+			      static_cast<int>(msg->data.result));
+		}
+		if (changed) {
+			if (auto data = GetSwitcher()) {
+				data->Wakeup(WakeupEvent::FILE_CHANGE);
+			}
+		}
+
+		f_curl_multi_remove_handle(multi, transfer->handle);
+		active.erase(std::remove_if(active.begin(), active.end(),
+					    [transfer](const auto &t) {
+						    return t.get() == transfer;
+					    }),
+			     active.end());
+	}
+}
+
+static void runWorker()
+{
+	CURLM *multi = f_curl_multi_init();
+	std::vector<std::unique_ptr<Transfer>> active;
+
+	while (!stopWorker) {
+		startQueuedTransfers(multi, active);
+		if (active.empty()) {
+			std::unique_lock<std::mutex> lock(cacheMutex);
+			queueCV.wait(lock, [] {
+				return stopWorker || !queue.empty();
+			});
+			continue;
+		}
+
+		int running = 0;
+		f_curl_multi_perform(multi, &running);
+		finishTransfers(multi, active);
+
+		int fds = 0;
+		f_curl_multi_wait(multi, nullptr, 0, pollTimeout, &fds);
+		// curl_multi_wait() returns immediately if there is nothing
+		// to wait for
+		if (fds == 0) {
+			std::this_thread::sleep_for(
+				std::chrono::milliseconds(pollTimeout));
+		}
+	}
+
+	for (const auto &transfer : active) {
+		f_curl_multi_remove_handle(multi, transfer->handle);
+	}
+	active.clear();
+	f_curl_multi_cleanup(multi);
+}
+
+HttpFetcher::Response HttpFetcher::Get(const std::string &url,
+				       std::chrono::milliseconds maxAge)
+{
+	if (!loaded_curl_lib || url.empty()) {
+		return {};
+	}
+
+	std::lock_guard<std::mutex> lock(cacheMutex);
+	const auto now = std::chrono::high_resolution_clock::now();
+	auto &entry = cache[url];
+	entry.lastAccess = now;
+	if (!entry.pending &&
+	    (!entry.fetched || now - entry.fetchTime >= maxAge)) {
+		entry.pending = true;
+		queue.push_back(url);
+		if (!worker.joinable()) {
+			stopWorker = false;
+			worker = std::thread(runWorker);
+		}
+		queueCV.notify_one();
+	}
+	return {entry.data, entry.version};
+}
+
+void HttpFetcher::Stop()
+{
+	std::thread stoppedWorker;
+	{
+		std::lock_guard<std::mutex> lock(cacheMutex);
+		stopWorker = true;
+		stoppedWorker = std::move(worker);
+	}
+	queueCV.notify_all();
+	if (stoppedWorker.joinable()) {
+		stoppedWorker.join();
+	}
+
+	std::lock_guard<std::mutex> lock(cacheMutex);
+	cache.clear();
+	queue.clear();
+}
@@ -18,15 +18,24 @@
 #undef Status
 #undef Unsorted
 #include <util/platform.h>
+#include <util/base.h>
+#include <algorithm>
 #include <vector>
 #include <thread>
+#include <mutex>
 #include <unordered_map>
 #include <QStringList>
 #include <QRegularExpression>
 #include <QLibrary>
+#include <QSet>
+#include "../headers/platform-funcs.hpp"
+#include "../headers/regex-cache.hpp"
 #include <proc/readproc.h>
 #include <fstream>
 #include <sstream>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
 
 static Display *xdisplay = 0;
 
@@ -52,11 +61,50 @@ void cleanupDisplay()
 	xdisplay = 0;
 }
 
+// Atoms stay valid as long as the display connection is open
+static struct {
+	bool initialized = false;
+	Atom netSupportingWmCheck;
+	Atom netClientList;
+	Atom netActiveWindow;
+	Atom netWmName;
+	Atom wmName;
+	Atom netWmPid;
+	Atom netWmState;
+	Atom netWmStateMaxVert;
+	Atom netWmStateMaxHorz;
+	Atom netWmStateFullscreen;
+} atoms;
+
+static void initAtoms()
+{
+	if (atoms.initialized) {
+		return;
+	}
+
+	auto display = disp();
+	atoms.netSupportingWmCheck =
+		XInternAtom(display, "_NET_SUPPORTING_WM_CHECK", false);
+	atoms.netClientList = XInternAtom(display, "_NET_CLIENT_LIST", false);
+	atoms.netActiveWindow =
+		XInternAtom(display, "_NET_ACTIVE_WINDOW", false);
+	atoms.netWmName = XInternAtom(display, "_NET_WM_NAME", false);
+	atoms.wmName = XInternAtom(display, "WM_NAME", false);
+	atoms.netWmPid = XInternAtom(display, "_NET_WM_PID", false);
+	atoms.netWmState = XInternAtom(display, "_NET_WM_STATE", false);
+	atoms.netWmStateMaxVert =
+		XInternAtom(display, "_NET_WM_STATE_MAXIMIZED_VERT", false);
+	atoms.netWmStateMaxHorz =
+		XInternAtom(display, "_NET_WM_STATE_MAXIMIZED_HORZ", false);
+	atoms.netWmStateFullscreen =
+		XInternAtom(display, "_NET_WM_STATE_FULLSCREEN", false);
+	atoms.initialized = true;
+}
+
 static bool ewmhIsSupported()
 {
 	Display *display = disp();
-	Atom netSupportingWmCheck =
-		XInternAtom(display, "_NET_SUPPORTING_WM_CHECK", true);
+	initAtoms();
 	Atom actualType;
 	int format = 0;
 	unsigned long num = 0, bytes = 0;
@@ -64,9 +112,9 @@ static bool ewmhIsSupported()
 	Window ewmh_window = 0;
 
 	int status = XGetWindowProperty(display, DefaultRootWindow(display),
-					netSupportingWmCheck, 0L, 1L, false,
-					XA_WINDOW, &actualType, &format, &num,
-					&bytes, &data);
+					atoms.netSupportingWmCheck, 0L, 1L,
+					false, XA_WINDOW, &actualType, &format,
+					&num, &bytes, &data);
 
 	if (status == Success) {
 		if (num > 0) {
@@ -80,9 +128,9 @@ static bool ewmhIsSupported()
 
 	if (ewmh_window) {
 		status = XGetWindowProperty(display, ewmh_window,
-					    netSupportingWmCheck, 0L, 1L, false,
-					    XA_WINDOW, &actualType, &format,
-					    &num, &bytes, &data);
+					    atoms.netSupportingWmCheck, 0L, 1L,
+					    false, XA_WINDOW, &actualType,
+					    &format, &num, &bytes, &data);
 		if (status != Success || num == 0 ||
 		    ewmh_window != ((Window *)data)[0]) {
 			ewmh_window = 0;
@@ -95,51 +143,101 @@ static bool ewmhIsSupported()
 	return ewmh_window != 0;
 }
 
-static QStringList getStates(Window window)
+struct WindowInfo {
+	Window id;
+	std::string title;
+	// The window states are only queried if they are needed
+	bool statesValid = false;
+	bool maximized = false;
+	bool fullscreen = false;
+};
+
+// Model of the top level windows.
+//
+// If the window manager supports it the model is kept up to date by a
+// background thread listening for property changes, so no requests to the X
+// server are necessary when checking the window conditions.
+// Otherwise it is rebuilt each time the window list is queried, which is
+// usually once per interval, and the window states and information about the
+// active window are fetched on demand.
+static struct {
+	std::mutex mutex;
+	bool eventBased = false;
+	bool ewmhSupported = false;
+	bool ewmhChecked = false;
+	std::vector<WindowInfo> windows;
+	Window activeWindow = 0;
+	std::string activeTitle;
+	bool activePidValid = false;
+	int activePid = -1;
+	std::string activeProcName;
+} snapshot;
+
+static struct {
+	Display *display = nullptr;
+	std::thread thread;
+	int stopPipe[2] = {-1, -1};
+	XErrorHandler prevErrorHandler = nullptr;
+} listener;
+
+static bool ewmhSupported()
 {
-	QStringList states;
+	if (!snapshot.ewmhChecked) {
+		snapshot.ewmhSupported = ewmhIsSupported();
+		snapshot.ewmhChecked = true;
+	}
+	return snapshot.ewmhSupported;
+}
 
-	if (!ewmhIsSupported())
-		return states;
+static void updateStates(Display *display, WindowInfo &window)
+{
+	window.statesValid = true;
+	window.maximized = false;
+	window.fullscreen = false;
 
-	Atom wmState = XInternAtom(disp(), "_NET_WM_STATE", true), type;
+	Atom type;
 	int format;
 	unsigned long num, bytes;
-	unsigned char *data;
-
-	int status = XGetWindowProperty(disp(), window, wmState, 0, ~0L, false,
-					AnyPropertyType, &type, &format, &num,
-					&bytes, &data);
+	unsigned char *data = nullptr;
 
-	if (status == Success)
-		for (unsigned long i = 0; i < num; i++)
-			states.append(QString(
-				XGetAtomName(disp(), ((Atom *)data)[i])));
+	int status = XGetWindowProperty(display, window.id, atoms.netWmState, 0,
+					~0L, false, AnyPropertyType, &type,
+					&format, &num, &bytes, &data);
+	if (status != Success || !data) {
+		return;
+	}
 
-	return states;
+	bool vertical = false;
+	bool horizontal = false;
+	for (unsigned long i = 0; i < num; i++) {
+		Atom state = ((Atom *)data)[i];
+		if (state == atoms.netWmStateMaxVert) {
+			vertical = true;
+		} else if (state == atoms.netWmStateMaxHorz) {
+			horizontal = true;
+		} else if (state == atoms.netWmStateFullscreen) {
+			window.fullscreen = true;
+		}
+	}
+	window.maximized = vertical && horizontal;
+	XFree(data);
 }
 
-static std::vector<Window> getTopLevelWindows()
+static std::vector<Window> getTopLevelWindows(Display *display)
 {
 	std::vector<Window> res;
 
-	res.resize(0);
-
-	if (!ewmhIsSupported()) {
-		return res;
-	}
-
-	Atom netClList = XInternAtom(disp(), "_NET_CLIENT_LIST", true);
 	Atom actualType;
 	int format;
 	unsigned long num, bytes;
 	Window *data = 0;
 
-	for (int i = 0; i < ScreenCount(disp()); ++i) {
-		Window rootWin = RootWindow(disp(), i);
+	for (int i = 0; i < ScreenCount(display); ++i) {
+		Window rootWin = RootWindow(display, i);
 
-		int status = XGetWindowProperty(disp(), rootWin, netClList, 0L,
-						~0L, false, AnyPropertyType,
+		int status = XGetWindowProperty(display, rootWin,
+						atoms.netClientList, 0L, ~0L,
+						false, AnyPropertyType,
 						&actualType, &format, &num,
 						&bytes, (uint8_t **)&data);
 
@@ -156,18 +254,15 @@ static std::vector<Window> getTopLevelWindows()
 	return res;
 }
 
-static std::string GetWindowTitle(size_t i)
+static std::string getWindowTitle(Display *display, Window w)
 {
-	Window w = getTopLevelWindows().at(i);
 	std::string windowTitle;
 	char *name;
 
 	XTextProperty text;
-	int status = XGetTextProperty(
-		disp(), w, &text, XInternAtom(disp(), "_NET_WM_NAME", true));
+	int status = XGetTextProperty(display, w, &text, atoms.netWmName);
 	if (status == 0)
-		status = XGetTextProperty(disp(), w, &text,
-					  XInternAtom(disp(), "WM_NAME", true));
+		status = XGetTextProperty(display, w, &text, atoms.wmName);
 	name = reinterpret_cast<char *>(text.value);
 
 	if (status != 0 && name != nullptr) {
@@ -179,68 +274,145 @@ static std::string GetWindowTitle(size_t i)
 	return windowTitle;
 }
 
-void GetWindowList(std::vector<std::string> &windows)
+static Window getActiveWindow(Display *display)
 {
-	windows.resize(0);
+	Atom actualType;
+	int format;
+	unsigned long num, bytes;
+	Window *data = 0;
+
+	Window rootWin = RootWindow(display, 0);
+
+	int xstatus = XGetWindowProperty(display, rootWin,
+					 atoms.netActiveWindow, 0L, ~0L, false,
+					 AnyPropertyType, &actualType, &format,
+					 &num, &bytes, (uint8_t **)&data);
+
+	if (data == nullptr) {
+		return 0;
+	}
 
-	for (size_t i = 0; i < getTopLevelWindows().size(); ++i) {
-		if (GetWindowTitle(i) != "")
-			windows.emplace_back(GetWindowTitle(i));
+	Window window = 0;
+	if (xstatus == Success && num > 0) {
+		window = data[0];
 	}
+	XFree(data);
+	return window;
 }
 
-// Overloaded
-void GetWindowList(QStringList &windows)
+static int getWindowPid(Display *display, Window window)
 {
-	windows.clear();
+	if (!window) {
+		return -1;
+	}
 
-	for (size_t i = 0; i < getTopLevelWindows().size(); ++i) {
-		if (GetWindowTitle(i) != "")
-			windows << QString::fromStdString(GetWindowTitle(i));
+	Atom actual_type;
+	int actual_format;
+	unsigned long nitems;
+	unsigned long bytes_after;
+	unsigned char *prop = nullptr;
+	auto status = XGetWindowProperty(display, window, atoms.netWmPid, 0, 1,
+					 False, XA_CARDINAL, &actual_type,
+					 &actual_format, &nitems, &bytes_after,
+					 &prop);
+
+	if (status != 0) {
+		return -2;
 	}
+	if (!prop) {
+		return -3;
+	}
+
+	int pid = -3;
+	if (nitems > 0) {
+		pid = (int)((unsigned long *)prop)[0];
+	}
+	XFree(prop);
+	return pid;
 }
 
-void GetCurrentWindowTitle(std::string &title)
+std::string getProcNameFromPid(int pid)
 {
-	if (!ewmhIsSupported()) {
+	std::string path = "/proc/" + std::to_string(pid) + "/comm";
+	std::ifstream t(path);
+	std::stringstream buffer;
+	buffer << t.rdbuf();
+	return buffer.str();
+}
+
+static void updateWindowSnapshot()
+{
+	if (snapshot.eventBased) {
 		return;
 	}
 
-	Atom active = XInternAtom(disp(), "_NET_ACTIVE_WINDOW", true);
-	Atom actualType;
-	int format;
-	unsigned long num, bytes;
-	Window *data = 0;
-	char *name;
+	snapshot.windows.clear();
+	if (!ewmhSupported()) {
+		return;
+	}
+	for (auto window : getTopLevelWindows(disp())) {
+		WindowInfo info;
+		info.id = window;
+		info.title = getWindowTitle(disp(), window);
+		if (!info.title.empty()) {
+			snapshot.windows.emplace_back(std::move(info));
+		}
+	}
+}
 
-	Window rootWin = RootWindow(disp(), 0);
+void GetWindowList(std::vector<std::string> &windows)
+{
+	std::lock_guard<std::mutex> lock(snapshot.mutex);
+	updateWindowSnapshot();
 
-	int xstatus = XGetWindowProperty(disp(), rootWin, active, 0L, ~0L,
-					 false, AnyPropertyType, &actualType,
-					 &format, &num, &bytes,
-					 (uint8_t **)&data);
+	windows.resize(0);
+	for (const auto &window : snapshot.windows) {
+		if (!window.title.empty()) {
+			windows.emplace_back(window.title);
+		}
+	}
+}
 
-	if (data == nullptr) {
+// Overloaded
+void GetWindowList(QStringList &windows)
+{
+	std::lock_guard<std::mutex> lock(snapshot.mutex);
+	updateWindowSnapshot();
+
+	windows.clear();
+	for (const auto &window : snapshot.windows) {
+		if (!window.title.empty()) {
+			windows << QString::fromStdString(window.title);
+		}
+	}
+}
+
+void GetCurrentWindowTitle(std::string &title)
+{
+	std::lock_guard<std::mutex> lock(snapshot.mutex);
+	if (snapshot.eventBased) {
+		if (!snapshot.activeTitle.empty()) {
+			title = snapshot.activeTitle;
+		}
 		return;
 	}
 
-	int status = 0;
-	XTextProperty text;
-	if (xstatus == Success && data[0]) {
-		status = XGetTextProperty(disp(), data[0], &text,
-					  XInternAtom(disp(), "_NET_WM_NAME",
-						      true));
-		if (status == 0)
-			status = XGetTextProperty(disp(), data[0], &text,
-						  XInternAtom(disp(), "WM_NAME",
-							      true));
+	// This is called once per interval so use it to detect changes of the
+	// window manager
+	snapshot.ewmhChecked = false;
+	snapshot.activeWindow = 0;
+	snapshot.activePidValid = false;
+	if (!ewmhSupported()) {
+		return;
 	}
-	name = reinterpret_cast<char *>(text.value);
 
-	if (status != 0 && name != nullptr) {
-		std::string str(name);
-		title = str;
-		XFree(name);
+	snapshot.activeWindow = getActiveWindow(disp());
+	if (!snapshot.activeWindow) {
+		return;
+	}
+	auto name = getWindowTitle(disp(), snapshot.activeWindow);
+	if (!name.empty()) {
+		title = name;
 	}
 }
 
@@ -267,185 +439,321 @@ std::pair<int, int> getCursorPos()
 	return pos;
 }
 
-bool isMaximized(const std::string &title)
+static WindowInfo *findWindow(const std::string &title)
 {
-	if (!ewmhIsSupported())
-		return false;
+	if (snapshot.windows.empty()) {
+		updateWindowSnapshot();
+	}
 
-	// Find switch in top level windows
-	std::vector<Window> windows = getTopLevelWindows();
-	for (auto &window : windows) {
-		XTextProperty text;
-		int status = XGetTextProperty(
-			disp(), window, &text,
-			XInternAtom(disp(), "_NET_WM_NAME", true));
-		if (status == 0)
-			status = XGetTextProperty(disp(), window, &text,
-						  XInternAtom(disp(), "WM_NAME",
-							      true));
-		char *name = reinterpret_cast<char *>(text.value);
-
-		if (status == 0 || name == nullptr)
+	auto expr = getRegex(QString::fromStdString(title));
+	for (auto &window : snapshot.windows) {
+		if (window.title.empty()) {
 			continue;
-
+		}
 		// True if switch equals window
-		bool equals = (title == name);
+		bool equals = (title == window.title);
 		// True if switch matches window
-		bool matches = QString::fromStdString(name).contains(
-			QRegularExpression(QString::fromStdString(title)));
-
-		// If found, check if switch is maximized
+		bool matches = QString::fromStdString(window.title)
+				       .contains(expr);
 		if (equals || matches) {
-			QStringList states = getStates(window);
-
-			if (!states.isEmpty()) {
-				// True if window is maximized vertically
-				bool vertical = states.contains(
-					"_NET_WM_STATE_MAXIMIZED_VERT");
-				// True if window is maximized horizontally
-				bool horizontal = states.contains(
-					"_NET_WM_STATE_MAXIMIZED_HORZ");
-
-				return (vertical && horizontal);
-			}
-
-			break;
+			return &window;
 		}
 	}
-
-	return false;
+	return nullptr;
 }
 
-bool isFullscreen(const std::string &title)
+bool isMaximized(const std::string &title)
 {
-	if (!ewmhIsSupported())
+	std::lock_guard<std::mutex> lock(snapshot.mutex);
+	if (!ewmhSupported())
 		return false;
 
-	// Find switch in top level windows
-	std::vector<Window> windows = getTopLevelWindows();
-	for (auto &window : windows) {
-		XTextProperty text;
-		int status = XGetTextProperty(
-			disp(), window, &text,
-			XInternAtom(disp(), "_NET_WM_NAME", true));
-		if (status == 0)
-			status = XGetTextProperty(disp(), window, &text,
-						  XInternAtom(disp(), "WM_NAME",
-							      true));
-		char *name = reinterpret_cast<char *>(text.value);
-
-		if (status == 0 || name == nullptr)
-			continue;
-
-		// True if switch equals window
-		bool equals = (title == name);
-		// True if switch matches window
-		bool matches = QString::fromStdString(name).contains(
-			QRegularExpression(QString::fromStdString(title)));
-
-		// If found, check if switch is fullscreen
-		if (equals || matches) {
-			QStringList states = getStates(window);
-
-			if (!states.isEmpty()) {
-				// True if window is fullscreen
-				bool fullscreen = states.contains(
-					"_NET_WM_STATE_FULLSCREEN");
+	auto window = findWindow(title);
+	if (!window) {
+		return false;
+	}
+	if (!window->statesValid) {
+		updateStates(disp(), *window);
+	}
+	return window->maximized;
+}
 
-				return (fullscreen);
-			}
+bool isFullscreen(const std::string &title)
+{
+	std::lock_guard<std::mutex> lock(snapshot.mutex);
+	if (!ewmhSupported())
+		return false;
 
-			break;
-		}
+	auto window = findWindow(title);
+	if (!window) {
+		return false;
 	}
-
-	return false;
+	if (!window->statesValid) {
+		updateStates(disp(), *window);
+	}
+	return window->fullscreen;
 }
 
 //exe switch is not quite what is expected but it works for now
 void GetProcessList(QStringList &processes)
 {
 	processes.clear();
+	QSet<QString> names;
 	PROCTAB *proc = openproc(PROC_FILLSTAT);
 	proc_t proc_info;
 	memset(&proc_info, 0, sizeof(proc_info));
 	while (readproc(proc, &proc_info) != NULL) {
 		QString procName(proc_info.cmd);
-		if (!procName.isEmpty() && !processes.contains(proc_info.cmd)) {
-			processes << QString(proc_info.cmd);
+		if (!procName.isEmpty() && !names.contains(procName)) {
+			names.insert(procName);
+			processes << procName;
 		}
 	}
 	closeproc(proc);
 }
 
-int getForegroundProcessPid()
+bool isInFocus(const QString &executable)
 {
-	if (!ewmhIsSupported()) {
-		return -1;
+	std::string current;
+	{
+		std::lock_guard<std::mutex> lock(snapshot.mutex);
+		if (!snapshot.activePidValid) {
+			snapshot.activePid =
+				ewmhSupported()
+					? getWindowPid(disp(),
+						       snapshot.activeWindow)
+					: -1;
+			snapshot.activeProcName =
+				getProcNameFromPid(snapshot.activePid);
+			snapshot.activePidValid = true;
+		}
+		current = snapshot.activeProcName;
 	}
 
-	auto dpy = disp();
-	Atom active = XInternAtom(dpy, "_NET_ACTIVE_WINDOW", true);
-	Atom actualType;
-	int format;
-	unsigned long num, bytes;
-	Window *window = 0;
-	int pid = -1;
+	// True if executable switch equals current window
+	bool equals = (executable.toStdString() == current);
+	// True if executable switch matches current window
+	bool matches = QString::fromStdString(current).contains(
+		getRegex(executable));
 
-	Window rootWin = RootWindow(dpy, 0);
+	return (equals || matches);
+}
 
-	int xstatus = XGetWindowProperty(dpy, rootWin, active, 0L, ~0L, false,
-					 AnyPropertyType, &actualType, &format,
-					 &num, &bytes, (uint8_t **)&window);
+bool WindowChangeEventsSupported()
+{
+	std::lock_guard<std::mutex> lock(snapshot.mutex);
+	return snapshot.eventBased;
+}
 
-	if (xstatus == 0 && window == nullptr) {
-		return -1;
+// Windows might be destroyed at any time, so errors caused by requests of the
+// listener thread for windows, which no longer exist, have to be ignored
+static int listenerErrorHandler(Display *display, XErrorEvent *error)
+{
+	if (display == listener.display) {
+		return 0;
 	}
+	if (listener.prevErrorHandler) {
+		return listener.prevErrorHandler(display, error);
+	}
+	return 0;
+}
 
-	Atom atom, actual_type;
-	int actual_format;
-	unsigned long nitems;
-	unsigned long bytes_after;
-	unsigned char *prop;
-	atom = XInternAtom(dpy, "_NET_WM_PID", True);
-	auto status = XGetWindowProperty(dpy, *window, atom, 0, 1024, False,
-					 AnyPropertyType, &actual_type,
-					 &actual_format, &nitems, &bytes_after,
-					 &prop);
+static void listenerUpdateWindows()
+{
+	auto display = listener.display;
+	std::vector<WindowInfo> known;
+	{
+		std::lock_guard<std::mutex> lock(snapshot.mutex);
+		known = snapshot.windows;
+	}
 
-	if (status != 0) {
-		return -2;
+	std::vector<WindowInfo> windows;
+	for (auto id : getTopLevelWindows(display)) {
+		auto it = std::find_if(known.begin(), known.end(),
+				       [id](const WindowInfo &w) {
+					       return w.id == id;
+				       });
+		if (it != known.end()) {
+			windows.emplace_back(*it);
+			continue;
+		}
+
+		XSelectInput(display, id, PropertyChangeMask);
+		WindowInfo info;
+		info.id = id;
+		info.title = getWindowTitle(display, id);
+		updateStates(display, info);
+		windows.emplace_back(std::move(info));
 	}
-	if (!prop) {
-		return -3;
+
+	std::lock_guard<std::mutex> lock(snapshot.mutex);
+	snapshot.windows = std::move(windows);
+}
+
+static void listenerUpdateActiveWindow()
+{
+	auto display = listener.display;
+	auto window = getActiveWindow(display);
+	std::string title;
+	if (window) {
+		title = getWindowTitle(display, window);
 	}
+	auto pid = getWindowPid(display, window);
+	auto procName = getProcNameFromPid(pid);
+
+	std::lock_guard<std::mutex> lock(snapshot.mutex);
+	snapshot.activeWindow = window;
+	snapshot.activeTitle = title;
+	snapshot.activePid = pid;
+	snapshot.activeProcName = procName;
+	snapshot.activePidValid = true;
+}
 
-	pid = prop[1] * 256;
-	pid += prop[0];
-	return pid;
+static void listenerUpdateWindow(Window id, bool title)
+{
+	auto display = listener.display;
+	WindowInfo info;
+	info.id = id;
+	if (title) {
+		info.title = getWindowTitle(display, id);
+	} else {
+		updateStates(display, info);
+	}
+
+	std::lock_guard<std::mutex> lock(snapshot.mutex);
+	if (title && id == snapshot.activeWindow) {
+		snapshot.activeTitle = info.title;
+	}
+	for (auto &window : snapshot.windows) {
+		if (window.id != id) {
+			continue;
+		}
+		if (title) {
+			window.title = info.title;
+		} else {
+			window.maximized = info.maximized;
+			window.fullscreen = info.fullscreen;
+		}
+	}
 }
 
-std::string getProcNameFromPid(int pid)
+// Returns true if the event might have changed the result of window related
+// checks
+static bool listenerHandleEvent(XEvent &event)
 {
-	std::string path = "/proc/" + std::to_string(pid) + "/comm";
-	std::ifstream t(path);
-	std::stringstream buffer;
-	buffer << t.rdbuf();
-	return buffer.str();
+	if (event.type != PropertyNotify) {
+		return false;
+	}
+
+	auto &e = event.xproperty;
+	bool isRoot = false;
+	for (int i = 0; i < ScreenCount(listener.display); ++i) {
+		isRoot = isRoot || e.window == RootWindow(listener.display, i);
+	}
+
+	if (isRoot) {
+		if (e.atom == atoms.netClientList) {
+			listenerUpdateWindows();
+			return true;
+		}
+		if (e.atom == atoms.netActiveWindow) {
+			listenerUpdateActiveWindow();
+			return true;
+		}
+		return false;
+	}
+	if (e.atom == atoms.netWmName || e.atom == atoms.wmName) {
+		listenerUpdateWindow(e.window, true);
+		return true;
+	}
+	if (e.atom == atoms.netWmState) {
+		listenerUpdateWindow(e.window, false);
+		return true;
+	}
+	return false;
 }
 
-bool isInFocus(const QString &executable)
+static void runWindowListener()
 {
-	auto pid = getForegroundProcessPid();
-	std::string current = getProcNameFromPid(pid);
+	auto display = listener.display;
+	for (int i = 0; i < ScreenCount(display); ++i) {
+		XSelectInput(display, RootWindow(display, i),
+			     PropertyChangeMask);
+	}
+	listenerUpdateWindows();
+	listenerUpdateActiveWindow();
+	{
+		std::lock_guard<std::mutex> lock(snapshot.mutex);
+		snapshot.eventBased = true;
+	}
 
-	// True if executable switch equals current window
-	bool equals = (executable.toStdString() == current);
-	// True if executable switch matches current window
-	bool matches = QString::fromStdString(current).contains(
-		QRegularExpression(executable));
+	while (true) {
+		bool changed = false;
+		while (XPending(display)) {
+			XEvent event;
+			XNextEvent(display, &event);
+			changed = listenerHandleEvent(event) || changed;
+		}
+		if (changed) {
+			NotifyWindowChange();
+		}
 
-	return (equals || matches);
+		pollfd fds[2] = {{ConnectionNumber(display), POLLIN, 0},
+				 {listener.stopPipe[0], POLLIN, 0}};
+		if (poll(fds, 2, -1) < 0 && errno != EINTR) {
+			break;
+		}
+		if (fds[1].revents) {
+			break;
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(snapshot.mutex);
+	snapshot.eventBased = false;
+	snapshot.windows.clear();
+	snapshot.activePidValid = false;
+}
+
+static void startWindowListener()
+{
+	{
+		std::lock_guard<std::mutex> lock(snapshot.mutex);
+		if (!ewmhSupported()) {
+			return;
+		}
+	}
+	if (pipe(listener.stopPipe) != 0) {
+		return;
+	}
+	listener.display = XOpenDisplay(NULL);
+	if (!listener.display) {
+		close(listener.stopPipe[0]);
+		close(listener.stopPipe[1]);
+		return;
+	}
+	listener.prevErrorHandler = XSetErrorHandler(listenerErrorHandler);
+	listener.thread = std::thread(runWindowListener);
+}
+
+static void stopWindowListener()
+{
+	if (!listener.thread.joinable()) {
+		return;
+	}
+
+	char stop = 0;
+	if (write(listener.stopPipe[1], &stop, 1) != 1) {
+		blog(LOG_WARNING, "failed to stop window listener");
+	}
+	listener.thread.join();
+	auto handler = XSetErrorHandler(listener.prevErrorHandler);
+	if (handler != listenerErrorHandler) {
+		XSetErrorHandler(handler);
+	}
+	XCloseDisplay(listener.display);
+	listener.display = nullptr;
+	close(listener.stopPipe[0]);
+	close(listener.stopPipe[1]);
 }
 
 int secondsSinceLastInput()
@@ -631,10 +939,13 @@ void PlatformInit()
 	int _;
 	canSimulateKeyPresses = pressFunc &&
 				!XQueryExtension(disp(), "XTEST", &_, &_, &_);
+	startWindowListener();
 }
 
 void PlatformCleanup()
 {
+	stopWindowListener();
+
 	delete libXtstHandle;
 	libXtstHandle = nullptr;
 
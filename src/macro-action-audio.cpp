@@ -24,117 +24,20 @@ const static std::map<FadeType, std::string> fadeTypes = {
 	{FadeType::RATE, "AdvSceneSwitcher.action.audio.fade.type.rate"},
 };
 
-constexpr auto fadeInterval = std::chrono::milliseconds(100);
-constexpr float minFade = 0.000001f;
-
-void MacroActionAudio::SetFadeActive(bool value)
-{
-	if (_action == AudioAction::SOURCE_VOLUME) {
-		switcher->activeAudioFades[GetWeakSourceName(_audioSource)]
-			.active = value;
-	} else {
-		switcher->masterAudioFade.active = value;
-	}
-}
-
-bool MacroActionAudio::FadeActive()
-{
-	bool active = true;
-	if (_action == AudioAction::SOURCE_VOLUME) {
-		auto it = switcher->activeAudioFades.find(
-			GetWeakSourceName(_audioSource));
-		if (it == switcher->activeAudioFades.end()) {
-			return false;
-		}
-		active = it->second.active;
-	} else {
-		active = switcher->masterAudioFade.active;
-	}
-
-	return active;
-}
-
-std::atomic_int *MacroActionAudio::GetFadeIdPtr()
-{
-
-	if (_action == AudioAction::SOURCE_VOLUME) {
-		auto it = switcher->activeAudioFades.find(
-			GetWeakSourceName(_audioSource));
-		if (it == switcher->activeAudioFades.end()) {
-			return nullptr;
-		}
-		return &it->second.id;
-	}
-	return &switcher->masterAudioFade.id;
-}
-
-void MacroActionAudio::SetVolume(float vol)
-{
-	if (_action == AudioAction::SOURCE_VOLUME) {
-		auto s = obs_weak_source_get_source(_audioSource);
-		obs_source_set_volume(s, vol);
-		obs_source_release(s);
-	} else {
-		obs_set_master_volume(vol);
-	}
-}
+const static std::map<FadeCurve, std::string> fadeCurves = {
+	{FadeCurve::LINEAR, "AdvSceneSwitcher.action.audio.fade.curve.linear"},
+	{FadeCurve::LOGARITHMIC,
+	 "AdvSceneSwitcher.action.audio.fade.curve.logarithmic"},
+	{FadeCurve::S_CURVE, "AdvSceneSwitcher.action.audio.fade.curve.sCurve"},
+};
 
-float MacroActionAudio::GetVolume()
+OBSWeakSource MacroActionAudio::GetFadeTarget()
 {
-	float curVol;
+	// The master volume is faded if no source is passed
 	if (_action == AudioAction::SOURCE_VOLUME) {
-		auto s = obs_weak_source_get_source(_audioSource);
-		if (!s) {
-			return 0.;
-		}
-		curVol = obs_source_get_volume(s);
-		obs_source_release(s);
-	} else {
-		curVol = obs_get_master_volume();
-	}
-	return curVol;
-}
-
-void MacroActionAudio::FadeVolume()
-{
-	float vol = (float)_volume / 100.0f;
-	float curVol = GetVolume();
-	bool volIncrease = curVol <= vol;
-	float volDiff = (volIncrease) ? vol - curVol : curVol - vol;
-	int nrSteps = 0;
-	float volStep = 0.;
-	if (_fadeType == FadeType::DURATION) {
-		nrSteps = _duration.seconds * 1000 / fadeInterval.count();
-		volStep = volDiff / nrSteps;
-	} else {
-		volStep = _rate / 1000.0f;
-		nrSteps = volDiff / volStep;
-	}
-
-	if (volStep < minFade || nrSteps <= 1) {
-		SetVolume(vol);
-		SetFadeActive(false);
-		return;
+		return _audioSource;
 	}
-
-	auto macro = GetMacro();
-	int step = 0;
-	auto fadeId = GetFadeIdPtr();
-	int expectedFadeId = ++(*fadeId);
-	for (; step < nrSteps && !macro->GetStop() && expectedFadeId == *fadeId;
-	     ++step) {
-		curVol = (volIncrease) ? curVol + volStep : curVol - volStep;
-		SetVolume(curVol);
-		std::this_thread::sleep_for(fadeInterval);
-	}
-
-	// As a final step set desired volume once again in case floating-point
-	// precision errors compounded to a noticeable error
-	if (step == nrSteps) {
-		SetVolume(vol);
-	}
-
-	SetFadeActive(false);
+	return nullptr;
 }
 
 void MacroActionAudio::StartFade()
@@ -143,7 +46,18 @@ void MacroActionAudio::StartFade()
 		return;
 	}
 
-	if (FadeActive() && !_abortActiveFade) {
+	const auto target = GetFadeTarget();
+	float vol = (float)_volume / 100.0f;
+	double seconds = _duration.seconds;
+	if (_fadeType == FadeType::RATE) {
+		float curVol = AudioFade::GetVolume(target);
+		float volDiff = (curVol <= vol) ? vol - curVol : curVol - vol;
+		seconds = volDiff / (_rate / 100.);
+	}
+
+	auto fade = AudioFade::Start(GetMacro(), target, vol, seconds,
+				     _fadeCurve, _abortActiveFade);
+	if (!fade) {
 		blog(LOG_WARNING,
 		     "Audio fade for volume of %s already active! New fade request will be ignored!",
 		     (_action == AudioAction::SOURCE_VOLUME)
@@ -151,13 +65,9 @@ void MacroActionAudio::StartFade()
 			     : "master volume");
 		return;
 	}
-	SetFadeActive(true);
 
 	if (_wait) {
-		FadeVolume();
-	} else {
-		GetMacro()->AddHelperThread(
-			std::thread(&MacroActionAudio::FadeVolume, this));
+		fade->Wait();
 	}
 }
 
@@ -176,7 +86,8 @@ bool MacroActionAudio::PerformAction()
 		if (_fade) {
 			StartFade();
 		} else {
-			SetVolume((float)_volume / 100.0f);
+			AudioFade::SetVolume(GetFadeTarget(),
+					     (float)_volume / 100.0f);
 		}
 		break;
 	default:
@@ -212,6 +123,7 @@ bool MacroActionAudio::Save(obs_data_t *obj)
 	obs_data_set_double(obj, "rate", _rate);
 	obs_data_set_bool(obj, "fade", _fade);
 	obs_data_set_int(obj, "fadeType", static_cast<int>(_fadeType));
+	obs_data_set_int(obj, "fadeCurve", static_cast<int>(_fadeCurve));
 	obs_data_set_bool(obj, "wait", _wait);
 	obs_data_set_bool(obj, "abortActiveFade", _abortActiveFade);
 	return true;
@@ -238,6 +150,7 @@ bool MacroActionAudio::Load(obs_data_t *obj)
 	} else {
 		_fadeType = FadeType::DURATION;
 	}
+	_fadeCurve = static_cast<FadeCurve>(obs_data_get_int(obj, "fadeCurve"));
 	if (obs_data_has_user_value(obj, "abortActiveFade")) {
 		_abortActiveFade = obs_data_get_bool(obj, "abortActiveFade");
 	} else {
@@ -268,12 +181,20 @@ static inline void populateFadeTypeSelection(QComboBox *list)
 	}
 }
 
+static inline void populateFadeCurveSelection(QComboBox *list)
+{
+	for (auto entry : fadeCurves) {
+		list->addItem(obs_module_text(entry.second.c_str()));
+	}
+}
+
 MacroActionAudioEdit::MacroActionAudioEdit(
 	QWidget *parent, std::shared_ptr<MacroActionAudio> entryData)
 	: QWidget(parent),
 	  _audioSources(new QComboBox),
 	  _actions(new QComboBox),
 	  _fadeTypes(new QComboBox),
+	  _fadeCurves(new QComboBox),
 	  _volumePercent(new QSpinBox),
 	  _fade(new QCheckBox),
 	  _duration(new DurationSelection(parent, false)),
@@ -283,6 +204,7 @@ MacroActionAudioEdit::MacroActionAudioEdit(
 	  _abortActiveFade(new QCheckBox(
 		  obs_module_text("AdvSceneSwitcher.action.audio.fade.abort"))),
 	  _fadeTypeLayout(new QHBoxLayout),
+	  _fadeCurveLayout(new QHBoxLayout),
 	  _fadeOptionsLayout(new QVBoxLayout)
 {
 	_volumePercent->setMinimum(0);
@@ -296,6 +218,7 @@ MacroActionAudioEdit::MacroActionAudioEdit(
 	populateActionSelection(_actions);
 	populateAudioSelection(_audioSources);
 	populateFadeTypeSelection(_fadeTypes);
+	populateFadeCurveSelection(_fadeCurves);
 
 	QWidget::connect(_actions, SIGNAL(currentIndexChanged(int)), this,
 			 SLOT(ActionChanged(int)));
@@ -316,6 +239,8 @@ MacroActionAudioEdit::MacroActionAudioEdit(
 			 SLOT(AbortActiveFadeChanged(int)));
 	QWidget::connect(_fadeTypes, SIGNAL(currentIndexChanged(int)), this,
 			 SLOT(FadeTypeChanged(int)));
+	QWidget::connect(_fadeCurves, SIGNAL(currentIndexChanged(int)), this,
+			 SLOT(FadeCurveChanged(int)));
 
 	std::unordered_map<std::string, QWidget *> widgetPlaceholders = {
 		{"{{audioSources}}", _audioSources},
@@ -327,6 +252,7 @@ MacroActionAudioEdit::MacroActionAudioEdit(
 		{"{{wait}}", _wait},
 		{"{{abortActiveFade}}", _abortActiveFade},
 		{"{{fadeTypes}}", _fadeTypes},
+		{"{{fadeCurves}}", _fadeCurves},
 	};
 	QHBoxLayout *entryLayout = new QHBoxLayout;
 	placeWidgets(obs_module_text("AdvSceneSwitcher.action.audio.entry"),
@@ -335,8 +261,12 @@ MacroActionAudioEdit::MacroActionAudioEdit(
 	placeWidgets(
 		obs_module_text("AdvSceneSwitcher.action.audio.fade.duration"),
 		_fadeTypeLayout, widgetPlaceholders);
+	placeWidgets(
+		obs_module_text("AdvSceneSwitcher.action.audio.fade.curve"),
+		_fadeCurveLayout, widgetPlaceholders);
 
 	_fadeOptionsLayout->addLayout(_fadeTypeLayout);
+	_fadeOptionsLayout->addLayout(_fadeCurveLayout);
 	_fadeOptionsLayout->addWidget(_abortActiveFade);
 	_fadeOptionsLayout->addWidget(_wait);
 
@@ -367,6 +297,7 @@ void MacroActionAudioEdit::SetWidgetVisibility()
 	_audioSources->setVisible(hasSourceControl(_entryData->_action));
 
 	_fadeTypes->setDisabled(!_entryData->_fade);
+	_fadeCurves->setDisabled(!_entryData->_fade);
 	_wait->setDisabled(!_entryData->_fade);
 	_abortActiveFade->setDisabled(!_entryData->_fade);
 	_duration->setDisabled(!_entryData->_fade);
@@ -420,6 +351,7 @@ void MacroActionAudioEdit::UpdateEntryData()
 	_wait->setChecked(_entryData->_wait);
 	_abortActiveFade->setChecked(_entryData->_abortActiveFade);
 	_fadeTypes->setCurrentIndex(static_cast<int>(_entryData->_fadeType));
+	_fadeCurves->setCurrentIndex(static_cast<int>(_entryData->_fadeCurve));
 	SetWidgetVisibility();
 }
 
@@ -517,3 +449,13 @@ void MacroActionAudioEdit::FadeTypeChanged(int value)
 	_entryData->_fadeType = static_cast<FadeType>(value);
 	SetWidgetVisibility();
 }
+
+void MacroActionAudioEdit::FadeCurveChanged(int value)
+{
+	if (_loading || !_entryData) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(switcher->m);
+	_entryData->_fadeCurve = static_cast<FadeCurve>(value);
+}
@@ -32,32 +32,31 @@ static std::map<AudioVolumeCondition, std::string> audioVolumeConditionTypes = {
 
 MacroConditionAudio::~MacroConditionAudio()
 {
-	obs_volmeter_remove_callback(_volmeter, SetVolumeLevel, this);
-	obs_volmeter_destroy(_volmeter);
+	ReleaseMeter();
 }
 
 bool MacroConditionAudio::CheckOutputCondition()
 {
+	if (!_meter) {
+		return false;
+	}
+
+	// Highest peak since roughly the last check
+	auto stats = _meter->GetStats(
+		std::chrono::milliseconds(switcher->interval));
 	bool ret = false;
-	auto s = obs_weak_source_get_source(_audioSource);
 
 	switch (_outputCondition) {
 	case AudioOutputCondition::ABOVE:
-		// peak will have a value from -60 db to 0 db
-		ret = ((double)_peak + 60) * 1.7 > _volume;
+		ret = AudioMeter::PeakToVolume(stats.maxPeak) > _volume;
 		break;
 	case AudioOutputCondition::BELOW:
-		// peak will have a value from -60 db to 0 db
-		ret = ((double)_peak + 60) * 1.7 < _volume;
+		ret = AudioMeter::PeakToVolume(stats.maxPeak) < _volume;
 		break;
 	default:
 		break;
 	}
 
-	// Reset for next check
-	_peak = -std::numeric_limits<float>::infinity();
-	obs_source_release(s);
-
 	return ret;
 }
 
@@ -91,6 +90,38 @@ bool MacroConditionAudio::CheckVolumeCondition()
 	return ret;
 }
 
+bool MacroConditionAudio::CheckLoudnessCondition()
+{
+	if (!_meter) {
+		return false;
+	}
+
+	double level;
+	auto window = std::chrono::milliseconds(_window);
+	if (_loudnessType == AudioLoudnessType::LUFS) {
+		level = _meter->GetLoudness(window);
+	} else {
+		level = _meter->GetStats(window).rms;
+	}
+
+	// Once matched the level has to move back past the threshold by the
+	// hysteresis before the condition no longer matches
+	const double hysteresis = _loudnessMatched ? _hysteresis : 0.;
+	switch (_outputCondition) {
+	case AudioOutputCondition::ABOVE:
+		_loudnessMatched = level > _loudnessThreshold - hysteresis;
+		break;
+	case AudioOutputCondition::BELOW:
+		_loudnessMatched = level < _loudnessThreshold + hysteresis;
+		break;
+	default:
+		_loudnessMatched = false;
+		break;
+	}
+
+	return _loudnessMatched;
+}
+
 bool MacroConditionAudio::CheckCondition()
 {
 	switch (_checkType) {
@@ -98,6 +129,8 @@ bool MacroConditionAudio::CheckCondition()
 		return CheckOutputCondition();
 	case AudioConditionCheckType::CONFIGURED_VOLUME:
 		return CheckVolumeCondition();
+	case AudioConditionCheckType::LOUDNESS:
+		return CheckLoudnessCondition();
 	default:
 		break;
 	}
@@ -115,26 +148,13 @@ bool MacroConditionAudio::Save(obs_data_t *obj)
 			 static_cast<int>(_outputCondition));
 	obs_data_set_int(obj, "volumeCondition",
 			 static_cast<int>(_volumeCondition));
+	obs_data_set_int(obj, "loudnessType", static_cast<int>(_loudnessType));
+	obs_data_set_double(obj, "loudnessThreshold", _loudnessThreshold);
+	obs_data_set_double(obj, "hysteresis", _hysteresis);
+	obs_data_set_int(obj, "window", _window);
 	return true;
 }
 
-obs_volmeter_t *AddVolmeterToSource(MacroConditionAudio *entry,
-				    obs_weak_source *source)
-{
-	obs_volmeter_t *volmeter = obs_volmeter_create(OBS_FADER_LOG);
-	obs_volmeter_add_callback(volmeter, MacroConditionAudio::SetVolumeLevel,
-				  entry);
-	obs_source_t *as = obs_weak_source_get_source(source);
-	if (!obs_volmeter_attach_source(volmeter, as)) {
-		const char *name = obs_source_get_name(as);
-		blog(LOG_WARNING, "failed to attach volmeter to source %s",
-		     name);
-	}
-	obs_source_release(as);
-
-	return volmeter;
-}
-
 // TODO: Remove in future version
 static void convertOldSettingsFormat(obs_data_t *obj)
 {
@@ -195,7 +215,15 @@ bool MacroConditionAudio::Load(obs_data_t *obj)
 		obs_data_get_int(obj, "outputCondition"));
 	_volumeCondition = static_cast<AudioVolumeCondition>(
 		obs_data_get_int(obj, "volumeCondition"));
-	_volmeter = AddVolmeterToSource(this, _audioSource);
+	if (obs_data_has_user_value(obj, "window")) {
+		_loudnessType = static_cast<AudioLoudnessType>(
+			obs_data_get_int(obj, "loudnessType"));
+		_loudnessThreshold =
+			obs_data_get_double(obj, "loudnessThreshold");
+		_hysteresis = obs_data_get_double(obj, "hysteresis");
+		_window = obs_data_get_int(obj, "window");
+	}
+	ResetVolmeter();
 	return true;
 }
 
@@ -207,29 +235,76 @@ std::string MacroConditionAudio::GetShortDesc()
 	return "";
 }
 
-void MacroConditionAudio::SetVolumeLevel(void *data, const float *,
-					 const float peak[MAX_AUDIO_CHANNELS],
-					 const float *)
+bool MacroConditionAudio::GetInputFingerprint(size_t &fingerprint)
 {
-	MacroConditionAudio *c = static_cast<MacroConditionAudio *>(data);
-	const auto macro = c->GetMacro();
-	if (macro && macro->Paused()) {
-		return;
+	if (_checkType != AudioConditionCheckType::OUTPUT_VOLUME) {
+		return false;
+	}
+
+	// If no new volume level was reported since the last check the
+	// previous result is still valid, but as the levels are evaluated over
+	// a window ending at the time of the check, it expires after at most
+	// one interval, e.g. once a source stops producing audio
+	hashCombine(fingerprint, _meter ? _meter->GetUpdateCount() : 0);
+	const auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::high_resolution_clock::now().time_since_epoch());
+	hashCombine(fingerprint, now.count() / std::max(switcher->interval, 1));
+	hashCombine(fingerprint, static_cast<size_t>(_outputCondition));
+	hashCombine(fingerprint, _volume);
+	hashCombine(fingerprint,
+		    std::hash<obs_weak_source_t *>()(_audioSource));
+	return true;
+}
+
+WakeupEvent MacroConditionAudio::GetWakeupEvents()
+{
+	if (_checkType == AudioConditionCheckType::OUTPUT_VOLUME) {
+		return WakeupEvent::AUDIO_LEVEL;
 	}
+	return WakeupEvent::NONE;
+}
+
+bool MacroConditionAudio::HasCheckSideEffects()
+{
+	// The output volume is evaluated over a fixed time window, but the
+	// loudness hysteresis depends on the result of the previous check
+	return _checkType == AudioConditionCheckType::LOUDNESS;
+}
 
-	for (int i = 0; i < MAX_AUDIO_CHANNELS; i++) {
-		if (peak[i] > c->_peak) {
-			c->_peak = peak[i];
-		}
+void MacroConditionAudio::ReleaseMeter()
+{
+	if (!_meter) {
+		return;
 	}
+	if (_wakeupThreshold >= 0) {
+		_meter->RemoveWakeupThreshold(_wakeupThreshold);
+	}
+	if (_loudnessEnabled) {
+		_meter->DisableLoudness();
+	}
+	_wakeupThreshold = -1;
+	_loudnessEnabled = false;
+	_meter.reset();
 }
 
 void MacroConditionAudio::ResetVolmeter()
 {
-	obs_volmeter_remove_callback(_volmeter, SetVolumeLevel, this);
-	obs_volmeter_destroy(_volmeter);
+	ReleaseMeter();
+	_loudnessMatched = false;
 
-	_volmeter = AddVolmeterToSource(this, _audioSource);
+	_meter = AudioMeter::Get(_audioSource);
+	if (!_meter) {
+		return;
+	}
+	if (_checkType == AudioConditionCheckType::OUTPUT_VOLUME) {
+		_wakeupThreshold = _volume;
+		_meter->AddWakeupThreshold(_wakeupThreshold);
+	}
+	if (_checkType == AudioConditionCheckType::LOUDNESS &&
+	    _loudnessType == AudioLoudnessType::LUFS) {
+		_meter->EnableLoudness();
+		_loudnessEnabled = true;
+	}
 }
 
 static inline void populateCheckTypes(QComboBox *list)
@@ -238,6 +313,16 @@ static inline void populateCheckTypes(QComboBox *list)
 		"AdvSceneSwitcher.condition.audio.type.output"));
 	list->addItem(obs_module_text(
 		"AdvSceneSwitcher.condition.audio.type.volume"));
+	list->addItem(obs_module_text(
+		"AdvSceneSwitcher.condition.audio.type.loudness"));
+}
+
+static inline void populateLoudnessTypes(QComboBox *list)
+{
+	list->addItem(obs_module_text(
+		"AdvSceneSwitcher.condition.audio.loudnessType.rms"));
+	list->addItem(obs_module_text(
+		"AdvSceneSwitcher.condition.audio.loudnessType.lufs"));
 }
 
 static inline void populateOutputConditionSelection(QComboBox *list)
@@ -264,10 +349,26 @@ MacroConditionAudioEdit::MacroConditionAudioEdit(
 	_audioSources = new QComboBox();
 	_condition = new QComboBox();
 	_volume = new QSpinBox();
+	_loudnessThreshold = new QDoubleSpinBox();
+	_loudnessType = new QComboBox();
+	_window = new QSpinBox();
+	_hysteresis = new QDoubleSpinBox();
 
 	_volume->setSuffix("%");
 	_volume->setMaximum(100);
 	_volume->setMinimum(0);
+	_loudnessThreshold->setMinimum(-70.);
+	_loudnessThreshold->setMaximum(0.);
+	_loudnessThreshold->setDecimals(1);
+	_window->setSuffix(" ms");
+	// Limited by the amount of levels kept by the audio meter
+	_window->setMinimum(100);
+	_window->setMaximum(10000);
+	_window->setSingleStep(100);
+	_hysteresis->setSuffix(" dB");
+	_hysteresis->setMinimum(0.);
+	_hysteresis->setMaximum(20.);
+	_hysteresis->setDecimals(1);
 
 	QWidget::connect(_checkTypes, SIGNAL(currentIndexChanged(int)), this,
 			 SLOT(CheckTypeChanged(int)));
@@ -278,9 +379,18 @@ MacroConditionAudioEdit::MacroConditionAudioEdit(
 	QWidget::connect(_audioSources,
 			 SIGNAL(currentTextChanged(const QString &)), this,
 			 SLOT(SourceChanged(const QString &)));
+	QWidget::connect(_loudnessThreshold, SIGNAL(valueChanged(double)),
+			 this, SLOT(LoudnessThresholdChanged(double)));
+	QWidget::connect(_loudnessType, SIGNAL(currentIndexChanged(int)), this,
+			 SLOT(LoudnessTypeChanged(int)));
+	QWidget::connect(_window, SIGNAL(valueChanged(int)), this,
+			 SLOT(WindowChanged(int)));
+	QWidget::connect(_hysteresis, SIGNAL(valueChanged(double)), this,
+			 SLOT(HysteresisChanged(double)));
 
 	populateCheckTypes(_checkTypes);
 	populateAudioSelection(_audioSources);
+	populateLoudnessTypes(_loudnessType);
 
 	QHBoxLayout *switchLayout = new QHBoxLayout;
 	std::unordered_map<std::string, QWidget *> widgetPlaceholders = {
@@ -288,13 +398,22 @@ MacroConditionAudioEdit::MacroConditionAudioEdit(
 		{"{{audioSources}}", _audioSources},
 		{"{{volume}}", _volume},
 		{"{{condition}}", _condition},
+		{"{{loudnessThreshold}}", _loudnessThreshold},
+		{"{{loudnessType}}", _loudnessType},
+		{"{{window}}", _window},
+		{"{{hysteresis}}", _hysteresis},
 	};
 	placeWidgets(obs_module_text("AdvSceneSwitcher.condition.audio.entry"),
 		     switchLayout, widgetPlaceholders);
+	_loudnessLayout = new QHBoxLayout;
+	placeWidgets(obs_module_text(
+			     "AdvSceneSwitcher.condition.audio.entry.loudness"),
+		     _loudnessLayout, widgetPlaceholders);
 
 	QVBoxLayout *mainLayout = new QVBoxLayout;
 
 	mainLayout->addLayout(switchLayout);
+	mainLayout->addLayout(_loudnessLayout);
 
 	setLayout(mainLayout);
 
@@ -346,6 +465,7 @@ void MacroConditionAudioEdit::VolumeThresholdChanged(int vol)
 
 	std::lock_guard<std::mutex> lock(switcher->m);
 	_entryData->_volume = vol;
+	_entryData->ResetVolmeter();
 }
 
 void MacroConditionAudioEdit::ConditionChanged(int cond)
@@ -355,7 +475,8 @@ void MacroConditionAudioEdit::ConditionChanged(int cond)
 	}
 
 	std::lock_guard<std::mutex> lock(switcher->m);
-	if (_entryData->_checkType == AudioConditionCheckType::OUTPUT_VOLUME) {
+	if (_entryData->_checkType !=
+	    AudioConditionCheckType::CONFIGURED_VOLUME) {
 		_entryData->_outputCondition =
 			static_cast<AudioOutputCondition>(cond);
 	} else {
@@ -373,9 +494,11 @@ void MacroConditionAudioEdit::CheckTypeChanged(int cond)
 
 	std::lock_guard<std::mutex> lock(switcher->m);
 	_entryData->_checkType = static_cast<AudioConditionCheckType>(cond);
+	_entryData->ResetVolmeter();
 
 	const QSignalBlocker b(_condition);
-	if (_entryData->_checkType == AudioConditionCheckType::OUTPUT_VOLUME) {
+	if (_entryData->_checkType !=
+	    AudioConditionCheckType::CONFIGURED_VOLUME) {
 		populateOutputConditionSelection(_condition);
 	} else {
 		populateVolumeConditionSelection(_condition);
@@ -383,6 +506,48 @@ void MacroConditionAudioEdit::CheckTypeChanged(int cond)
 	SetWidgetVisibility();
 }
 
+void MacroConditionAudioEdit::LoudnessTypeChanged(int type)
+{
+	if (_loading || !_entryData) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(switcher->m);
+	_entryData->_loudnessType = static_cast<AudioLoudnessType>(type);
+	_entryData->ResetVolmeter();
+	SetWidgetVisibility();
+}
+
+void MacroConditionAudioEdit::LoudnessThresholdChanged(double value)
+{
+	if (_loading || !_entryData) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(switcher->m);
+	_entryData->_loudnessThreshold = value;
+}
+
+void MacroConditionAudioEdit::HysteresisChanged(double value)
+{
+	if (_loading || !_entryData) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(switcher->m);
+	_entryData->_hysteresis = value;
+}
+
+void MacroConditionAudioEdit::WindowChanged(int value)
+{
+	if (_loading || !_entryData) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(switcher->m);
+	_entryData->_window = value;
+}
+
 void MacroConditionAudioEdit::UpdateEntryData()
 {
 	if (!_entryData) {
@@ -393,7 +558,13 @@ void MacroConditionAudioEdit::UpdateEntryData()
 		GetWeakSourceName(_entryData->_audioSource).c_str());
 	_volume->setValue(_entryData->_volume);
 	_checkTypes->setCurrentIndex(static_cast<int>(_entryData->_checkType));
-	if (_entryData->_checkType == AudioConditionCheckType::OUTPUT_VOLUME) {
+	_loudnessThreshold->setValue(_entryData->_loudnessThreshold);
+	_loudnessType->setCurrentIndex(
+		static_cast<int>(_entryData->_loudnessType));
+	_window->setValue(_entryData->_window);
+	_hysteresis->setValue(_entryData->_hysteresis);
+	if (_entryData->_checkType !=
+	    AudioConditionCheckType::CONFIGURED_VOLUME) {
 		populateOutputConditionSelection(_condition);
 		_condition->setCurrentIndex(
 			static_cast<int>(_entryData->_outputCondition));
@@ -422,5 +593,13 @@ void MacroConditionAudioEdit::SetWidgetVisibility()
 		  _entryData->_volumeCondition == AudioVolumeCondition::BELOW)));
 	_volMeter->setVisible(_entryData->_checkType ==
 			      AudioConditionCheckType::OUTPUT_VOLUME);
+
+	const bool loudness = _entryData->_checkType ==
+			      AudioConditionCheckType::LOUDNESS;
+	_loudnessThreshold->setVisible(loudness);
+	_loudnessThreshold->setSuffix(
+		_entryData->_loudnessType == AudioLoudnessType::LUFS ? " LUFS"
+								     : " dB");
+	setLayoutVisible(_loudnessLayout, loudness);
 	adjustSize();
 }
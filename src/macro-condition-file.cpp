@@ -2,7 +2,7 @@
 #include "headers/macro-condition-file.hpp"
 #include "headers/utility.hpp"
 #include "headers/advanced-scene-switcher.hpp"
-#include "headers/curl-helper.hpp"
+#include "headers/http-fetcher.hpp"
 
 #include <QTextStream>
 #include <QFileDialog>
@@ -16,33 +16,20 @@ bool MacroConditionFile::_registered = MacroConditionFactory::Register(
 
 static std::hash<std::string> strHash;
 
-static size_t WriteCallback(void *contents, size_t size, size_t nmemb,
-			    void *userp)
+MacroConditionFile::MacroConditionFile(Macro *m) : MacroCondition(m)
 {
-	((std::string *)userp)->append((char *)contents, size * nmemb);
-	return size * nmemb;
-}
-
-static std::string getRemoteData(std::string &url)
-{
-	std::string readBuffer;
-
-	if (switcher->curl && f_curl_setopt && f_curl_perform) {
-		f_curl_setopt(switcher->curl, CURLOPT_URL, url.c_str());
-		f_curl_setopt(switcher->curl, CURLOPT_WRITEFUNCTION,
-			      WriteCallback);
-		f_curl_setopt(switcher->curl, CURLOPT_WRITEDATA, &readBuffer);
-
-		// Set timeout to at least one second
-		int timeout = switcher->interval / 1000;
-		if (timeout == 0) {
-			timeout = 1;
-		}
-		f_curl_setopt(switcher->curl, CURLOPT_TIMEOUT, 1);
-
-		f_curl_perform(switcher->curl);
-	}
-	return readBuffer;
+	_refreshInterval.seconds = 1.;
+	QObject::connect(
+		&_watcher, &QFileSystemWatcher::fileChanged,
+		[this](const QString &path) {
+			// Some editors replace the file instead of modifying
+			// it, which removes it from the list of watched files
+			if (!_watcher.files().contains(path) &&
+			    QFileInfo::exists(path)) {
+				_watcher.addPath(path);
+			}
+			switcher->Wakeup(WakeupEvent::FILE_CHANGE);
+		});
 }
 
 bool MacroConditionFile::matchFileContent(QString &filedata)
@@ -64,10 +51,19 @@ bool MacroConditionFile::matchFileContent(QString &filedata)
 	return compareIgnoringLineEnding(text, filedata);
 }
 
+std::chrono::milliseconds MacroConditionFile::getRefreshInterval()
+{
+	return std::chrono::milliseconds(
+		static_cast<long long>(_refreshInterval.seconds * 1000));
+}
+
 bool MacroConditionFile::checkRemoteFileContent()
 {
-	std::string data = getRemoteData(_file);
-	QString qdata = QString::fromStdString(data);
+	auto response = HttpFetcher::Get(_file, getRefreshInterval());
+	if (response.version == 0) {
+		return false;
+	}
+	QString qdata = QString::fromStdString(response.data);
 	return matchFileContent(qdata);
 }
 
@@ -103,6 +99,75 @@ bool MacroConditionFile::CheckCondition()
 	}
 }
 
+bool MacroConditionFile::GetInputFingerprint(size_t &fingerprint)
+{
+	// Matching only on changes relies on the state updated in each check
+	if (_onlyMatchIfChanged) {
+		return false;
+	}
+
+	if (_fileType == FileType::REMOTE) {
+		auto response = HttpFetcher::Get(_file, getRefreshInterval());
+		hashCombine(fingerprint, response.version);
+		hashCombine(fingerprint, strHash(_file));
+		hashCombine(fingerprint, strHash(_text));
+		hashCombine(fingerprint, _useRegex);
+		return true;
+	}
+
+	if (_useTime) {
+		return false;
+	}
+
+	QFileInfo info(QString::fromStdString(_file));
+	if (!info.exists()) {
+		return false;
+	}
+
+	hashCombine(fingerprint, info.lastModified().toMSecsSinceEpoch());
+	hashCombine(fingerprint, info.size());
+	hashCombine(fingerprint, strHash(_file));
+	hashCombine(fingerprint, strHash(_text));
+	hashCombine(fingerprint, _useRegex);
+	return true;
+}
+
+ConditionCost MacroConditionFile::GetCost()
+{
+	// Remote data is fetched in the background, so checks only have to
+	// match the cached data
+	return ConditionCost::MEDIUM;
+}
+
+bool MacroConditionFile::CanBeCheckedConcurrently()
+{
+	return true;
+}
+
+WakeupEvent MacroConditionFile::GetWakeupEvents()
+{
+	// Remote files trigger a wakeup once different data was fetched
+	return WakeupEvent::FILE_CHANGE;
+}
+
+bool MacroConditionFile::HasCheckSideEffects()
+{
+	// Changes are only reported to the first check after the change
+	return _onlyMatchIfChanged ||
+	       (_fileType == FileType::LOCAL && _useTime);
+}
+
+void MacroConditionFile::UpdateFileWatcher()
+{
+	if (!_watcher.files().isEmpty()) {
+		_watcher.removePaths(_watcher.files());
+	}
+	QString path = QString::fromStdString(_file);
+	if (_fileType == FileType::LOCAL && QFileInfo::exists(path)) {
+		_watcher.addPath(path);
+	}
+}
+
 bool MacroConditionFile::Save(obs_data_t *obj)
 {
 	MacroCondition::Save(obj);
@@ -112,6 +177,7 @@ bool MacroConditionFile::Save(obs_data_t *obj)
 	obs_data_set_bool(obj, "useRegex", _useRegex);
 	obs_data_set_bool(obj, "useTime", _useTime);
 	obs_data_set_bool(obj, "onlyMatchIfChanged", _onlyMatchIfChanged);
+	_refreshInterval.Save(obj, "refreshInterval", "refreshIntervalUnit");
 	return true;
 }
 
@@ -124,6 +190,11 @@ bool MacroConditionFile::Load(obs_data_t *obj)
 	_useRegex = obs_data_get_bool(obj, "useRegex");
 	_useTime = obs_data_get_bool(obj, "useTime");
 	_onlyMatchIfChanged = obs_data_get_bool(obj, "onlyMatchIfChanged");
+	if (obs_data_has_user_value(obj, "refreshInterval")) {
+		_refreshInterval.Load(obj, "refreshInterval",
+				      "refreshIntervalUnit");
+	}
+	UpdateFileWatcher();
 	return true;
 }
 
@@ -145,6 +216,8 @@ MacroConditionFileEdit::MacroConditionFileEdit(
 		"AdvSceneSwitcher.fileTab.checkfileContentTime"));
 	_checkFileContent = new QCheckBox(
 		obs_module_text("AdvSceneSwitcher.fileTab.checkfileContent"));
+	_refreshInterval = new DurationSelection();
+	_refreshIntervalLayout = new QHBoxLayout;
 
 	QWidget::connect(_fileType, SIGNAL(currentIndexChanged(int)), this,
 			 SLOT(FileTypeChanged(int)));
@@ -158,6 +231,10 @@ MacroConditionFileEdit::MacroConditionFileEdit(
 			 this, SLOT(CheckModificationDateChanged(int)));
 	QWidget::connect(_checkFileContent, SIGNAL(stateChanged(int)), this,
 			 SLOT(OnlyMatchIfChangedChanged(int)));
+	QWidget::connect(_refreshInterval, SIGNAL(DurationChanged(double)),
+			 this, SLOT(RefreshIntervalChanged(double)));
+	QWidget::connect(_refreshInterval, SIGNAL(UnitChanged(DurationUnit)),
+			 this, SLOT(RefreshIntervalUnitChanged(DurationUnit)));
 
 	_fileType->addItem(obs_module_text("AdvSceneSwitcher.fileTab.local"));
 	_fileType->addItem(obs_module_text("AdvSceneSwitcher.fileTab.remote"));
@@ -169,6 +246,7 @@ MacroConditionFileEdit::MacroConditionFileEdit(
 		{"{{useRegex}}", _useRegex},
 		{"{{checkModificationDate}}", _checkModificationDate},
 		{"{{checkFileContent}}", _checkFileContent},
+		{"{{refreshInterval}}", _refreshInterval},
 	};
 
 	QVBoxLayout *mainLayout = new QVBoxLayout;
@@ -184,9 +262,13 @@ MacroConditionFileEdit::MacroConditionFileEdit(
 	placeWidgets(
 		obs_module_text("AdvSceneSwitcher.condition.file.entry.line3"),
 		line3Layout, widgetPlaceholders);
+	placeWidgets(
+		obs_module_text("AdvSceneSwitcher.condition.file.entry.line4"),
+		_refreshIntervalLayout, widgetPlaceholders);
 	mainLayout->addLayout(line1Layout);
 	mainLayout->addLayout(line2Layout);
 	mainLayout->addLayout(line3Layout);
+	mainLayout->addLayout(_refreshIntervalLayout);
 
 	setLayout(mainLayout);
 
@@ -208,6 +290,8 @@ void MacroConditionFileEdit::UpdateEntryData()
 	_useRegex->setChecked(_entryData->_useRegex);
 	_checkModificationDate->setChecked(_entryData->_useTime);
 	_checkFileContent->setChecked(_entryData->_onlyMatchIfChanged);
+	_refreshInterval->SetDuration(_entryData->_refreshInterval);
+	SetWidgetVisibility();
 
 	adjustSize();
 	updateGeometry();
@@ -219,18 +303,10 @@ void MacroConditionFileEdit::FileTypeChanged(int index)
 		return;
 	}
 
-	FileType type = static_cast<FileType>(index);
-
-	if (type == FileType::LOCAL) {
-		_filePath->Button()->setDisabled(false);
-		_checkModificationDate->setDisabled(false);
-	} else {
-		_filePath->Button()->setDisabled(true);
-		_checkModificationDate->setDisabled(true);
-	}
-
 	std::lock_guard<std::mutex> lock(switcher->m);
-	_entryData->_fileType = type;
+	_entryData->_fileType = static_cast<FileType>(index);
+	_entryData->UpdateFileWatcher();
+	SetWidgetVisibility();
 }
 
 void MacroConditionFileEdit::PathChanged(const QString &text)
@@ -241,6 +317,7 @@ void MacroConditionFileEdit::PathChanged(const QString &text)
 
 	std::lock_guard<std::mutex> lock(switcher->m);
 	_entryData->_file = text.toUtf8().constData();
+	_entryData->UpdateFileWatcher();
 	emit HeaderInfoChanged(
 		QString::fromStdString(_entryData->GetShortDesc()));
 }
@@ -287,3 +364,38 @@ void MacroConditionFileEdit::OnlyMatchIfChangedChanged(int state)
 	std::lock_guard<std::mutex> lock(switcher->m);
 	_entryData->_onlyMatchIfChanged = state;
 }
+
+void MacroConditionFileEdit::RefreshIntervalChanged(double seconds)
+{
+	if (_loading || !_entryData) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(switcher->m);
+	_entryData->_refreshInterval.seconds = seconds;
+}
+
+void MacroConditionFileEdit::RefreshIntervalUnitChanged(DurationUnit unit)
+{
+	if (_loading || !_entryData) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(switcher->m);
+	_entryData->_refreshInterval.displayUnit = unit;
+}
+
+void MacroConditionFileEdit::SetWidgetVisibility()
+{
+	if (!_entryData) {
+		return;
+	}
+
+	const bool remote = _entryData->_fileType == FileType::REMOTE;
+	_filePath->Button()->setDisabled(remote);
+	_checkModificationDate->setDisabled(remote);
+	setLayoutVisible(_refreshIntervalLayout, remote);
+
+	adjustSize();
+	updateGeometry();
+}
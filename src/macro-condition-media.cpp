@@ -334,6 +334,7 @@ void MacroConditionMedia::MediaStopped(void *data, calldata_t *)
 		return;
 	}
 	media->_stopped = true;
+	switcher->Wakeup(WakeupEvent::MEDIA_STATE);
 }
 
 void MacroConditionMedia::MediaEnded(void *data, calldata_t *)
@@ -344,6 +345,7 @@ void MacroConditionMedia::MediaEnded(void *data, calldata_t *)
 		return;
 	}
 	media->_ended = true;
+	switcher->Wakeup(WakeupEvent::MEDIA_STATE);
 }
 
 void MacroConditionMedia::MediaNext(void *data, calldata_t *)
@@ -354,6 +356,7 @@ void MacroConditionMedia::MediaNext(void *data, calldata_t *)
 		return;
 	}
 	media->_next = true;
+	switcher->Wakeup(WakeupEvent::MEDIA_STATE);
 }
 
 static void populateMediaTimeRestrictions(QComboBox *list)
@@ -2,8 +2,7 @@
 #include "headers/macro-condition-process.hpp"
 #include "headers/utility.hpp"
 #include "headers/advanced-scene-switcher.hpp"
-
-#include <regex>
+#include "headers/regex-cache.hpp"
 
 const std::string MacroConditionProcess::id = "process";
 
@@ -14,12 +13,11 @@ bool MacroConditionProcess::_registered = MacroConditionFactory::Register(
 
 bool MacroConditionProcess::CheckCondition()
 {
-	QStringList runningProcesses;
 	QString proc = QString::fromStdString(_process);
-	GetProcessList(runningProcesses);
+	auto &runningProcesses = switcher->getProcessList();
 
-	bool equals = runningProcesses.contains(proc);
-	bool matches = runningProcesses.indexOf(QRegularExpression(proc)) != -1;
+	bool equals = switcher->isProcessRunning(proc);
+	bool matches = !equals && containsRegexMatch(runningProcesses, proc);
 	bool focus = !_focus || isInFocus(proc);
 
 	return (equals || matches) && focus;
@@ -54,6 +54,50 @@ bool MacroConditionScene::CheckCondition()
 	return false;
 }
 
+WakeupEvent MacroConditionScene::GetWakeupEvents()
+{
+	return WakeupEvent::SCENE_CHANGE | WakeupEvent::TRANSITION;
+}
+
+bool MacroConditionScene::HasCheckSideEffects()
+{
+	// Scene changes are only reported to the first check after the change
+	return _type == SceneType::CHANGED || _type == SceneType::NOTCHANGED;
+}
+
+bool MacroConditionScene::RequiresPolling()
+{
+	switch (_type) {
+	case SceneType::CURRENT:
+	case SceneType::CHANGED:
+		return false;
+	case SceneType::PREVIOUS:
+		// Start of transitions is not reported as an event
+		return _useTransitionTargetScene;
+	default:
+		break;
+	}
+	return true;
+}
+
+bool MacroConditionScene::GetInputFingerprint(size_t &fingerprint)
+{
+	// The "changed" types rely on the state updated in each check
+	if ((_type != SceneType::CURRENT && _type != SceneType::PREVIOUS) ||
+	    _useTransitionTargetScene) {
+		return false;
+	}
+
+	std::hash<obs_weak_source_t *> ptrHash;
+	hashCombine(fingerprint, static_cast<size_t>(_type));
+	hashCombine(fingerprint, ptrHash(_scene.GetScene(false)));
+	hashCombine(fingerprint, ptrHash(switcher->currentScene));
+	hashCombine(fingerprint, ptrHash(switcher->previousScene));
+	hashCombine(fingerprint,
+		    switcher->lastSceneChangeTime.time_since_epoch().count());
+	return true;
+}
+
 bool MacroConditionScene::Save(obs_data_t *obj)
 {
 	MacroCondition::Save(obj);
@@ -129,12 +129,33 @@ void MacroConditionTransition::TransitionStarted(void *data, calldata_t *)
 {
 	auto *transitionCond = static_cast<MacroConditionTransition *>(data);
 	transitionCond->_started = true;
+	switcher->Wakeup(WakeupEvent::TRANSITION);
 }
 
 void MacroConditionTransition::TransitionEnded(void *data, calldata_t *)
 {
 	auto *transitionCond = static_cast<MacroConditionTransition *>(data);
 	transitionCond->_ended = true;
+	switcher->Wakeup(WakeupEvent::TRANSITION);
+}
+
+WakeupEvent MacroConditionTransition::GetWakeupEvents()
+{
+	return WakeupEvent::TRANSITION | WakeupEvent::SCENE_CHANGE;
+}
+
+bool MacroConditionTransition::RequiresPolling()
+{
+	switch (_condition) {
+	case TransitionCondition::STARTED:
+		// Start of scene transitions is not reported as an event
+		return _transition.GetType() == TransitionSelectionType::ANY;
+	case TransitionCondition::ENDED:
+		return false;
+	default:
+		break;
+	}
+	return true;
 }
 
 bool MacroConditionTransition::Save(obs_data_t *obj)
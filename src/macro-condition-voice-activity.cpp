@@ -0,0 +1,160 @@
+#include "headers/macro-condition-edit.hpp"
+#include "headers/macro-condition-voice-activity.hpp"
+#include "headers/utility.hpp"
+#include "headers/advanced-scene-switcher.hpp"
+
+const std::string MacroConditionVoiceActivity::id = "voice_activity";
+
+bool MacroConditionVoiceActivity::_registered =
+	MacroConditionFactory::Register(
+		MacroConditionVoiceActivity::id,
+		{MacroConditionVoiceActivity::Create,
+		 MacroConditionVoiceActivityEdit::Create,
+		 "AdvSceneSwitcher.condition.voiceActivity"});
+
+static std::map<MacroConditionVoiceActivity::State, std::string> states = {
+	{MacroConditionVoiceActivity::State::SPEAKING,
+	 "AdvSceneSwitcher.condition.voiceActivity.state.speaking"},
+	{MacroConditionVoiceActivity::State::SILENT,
+	 "AdvSceneSwitcher.condition.voiceActivity.state.silent"},
+};
+
+bool MacroConditionVoiceActivity::CheckCondition()
+{
+	if (!_detector) {
+		return false;
+	}
+
+	const bool speaking = _detector->IsSpeaking();
+	if (speaking != (_state == State::SPEAKING)) {
+		return false;
+	}
+	return _detector->GetStateDuration().count() >= _duration;
+}
+
+bool MacroConditionVoiceActivity::Save(obs_data_t *obj)
+{
+	MacroCondition::Save(obj);
+	obs_data_set_string(obj, "audioSource",
+			    GetWeakSourceName(_audioSource).c_str());
+	obs_data_set_int(obj, "state", static_cast<int>(_state));
+	obs_data_set_int(obj, "duration", _duration);
+	return true;
+}
+
+bool MacroConditionVoiceActivity::Load(obs_data_t *obj)
+{
+	MacroCondition::Load(obj);
+	const char *audioSourceName = obs_data_get_string(obj, "audioSource");
+	_audioSource = GetWeakSourceByName(audioSourceName);
+	_state = static_cast<State>(obs_data_get_int(obj, "state"));
+	_duration = obs_data_get_int(obj, "duration");
+	ResetDetector();
+	return true;
+}
+
+std::string MacroConditionVoiceActivity::GetShortDesc()
+{
+	if (_audioSource) {
+		return GetWeakSourceName(_audioSource);
+	}
+	return "";
+}
+
+void MacroConditionVoiceActivity::ResetDetector()
+{
+	_detector = VoiceActivityDetector::Get(_audioSource);
+}
+
+static inline void populateStateSelection(QComboBox *list)
+{
+	for (auto entry : states) {
+		list->addItem(obs_module_text(entry.second.c_str()));
+	}
+}
+
+MacroConditionVoiceActivityEdit::MacroConditionVoiceActivityEdit(
+	QWidget *parent, std::shared_ptr<MacroConditionVoiceActivity> entryData)
+	: QWidget(parent)
+{
+	_audioSources = new QComboBox();
+	_states = new QComboBox();
+	_duration = new QSpinBox();
+
+	_duration->setSuffix(" ms");
+	_duration->setMinimum(0);
+	_duration->setMaximum(999999);
+	_duration->setSingleStep(100);
+
+	QWidget::connect(_audioSources,
+			 SIGNAL(currentTextChanged(const QString &)), this,
+			 SLOT(SourceChanged(const QString &)));
+	QWidget::connect(_states, SIGNAL(currentIndexChanged(int)), this,
+			 SLOT(StateChanged(int)));
+	QWidget::connect(_duration, SIGNAL(valueChanged(int)), this,
+			 SLOT(DurationChanged(int)));
+
+	populateAudioSelection(_audioSources);
+	populateStateSelection(_states);
+
+	QHBoxLayout *mainLayout = new QHBoxLayout;
+	std::unordered_map<std::string, QWidget *> widgetPlaceholders = {
+		{"{{audioSources}}", _audioSources},
+		{"{{states}}", _states},
+		{"{{duration}}", _duration},
+	};
+	placeWidgets(obs_module_text(
+			     "AdvSceneSwitcher.condition.voiceActivity.entry"),
+		     mainLayout, widgetPlaceholders);
+	setLayout(mainLayout);
+
+	_entryData = entryData;
+	UpdateEntryData();
+	_loading = false;
+}
+
+void MacroConditionVoiceActivityEdit::SourceChanged(const QString &text)
+{
+	if (_loading || !_entryData) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(switcher->m);
+	_entryData->_audioSource = GetWeakSourceByQString(text);
+	_entryData->ResetDetector();
+	emit HeaderInfoChanged(
+		QString::fromStdString(_entryData->GetShortDesc()));
+}
+
+void MacroConditionVoiceActivityEdit::StateChanged(int state)
+{
+	if (_loading || !_entryData) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(switcher->m);
+	_entryData->_state =
+		static_cast<MacroConditionVoiceActivity::State>(state);
+}
+
+void MacroConditionVoiceActivityEdit::DurationChanged(int duration)
+{
+	if (_loading || !_entryData) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(switcher->m);
+	_entryData->_duration = duration;
+}
+
+void MacroConditionVoiceActivityEdit::UpdateEntryData()
+{
+	if (!_entryData) {
+		return;
+	}
+
+	_audioSources->setCurrentText(
+		GetWeakSourceName(_entryData->_audioSource).c_str());
+	_states->setCurrentIndex(static_cast<int>(_entryData->_state));
+	_duration->setValue(_entryData->_duration);
+}
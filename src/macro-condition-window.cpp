@@ -1,10 +1,9 @@
 #include "headers/macro-condition-edit.hpp"
 #include "headers/macro-condition-window.hpp"
 #include "headers/utility.hpp"
+#include "headers/regex-cache.hpp"
 #include "headers/advanced-scene-switcher.hpp"
 
-#include <regex>
-
 const std::string MacroConditionWindow::id = "window";
 
 bool MacroConditionWindow::_registered = MacroConditionFactory::Register(
@@ -23,16 +22,15 @@ bool MacroConditionWindow::CheckWindowTitleSwitchDirect(
 }
 
 bool MacroConditionWindow::CheckWindowTitleSwitchRegex(
-	std::string &currentWindowTitle, std::vector<std::string> &windowList)
+	std::string &currentWindowTitle,
+	const std::vector<std::string> &windowList)
 {
 	bool match = false;
+	auto expr = getRegex(QString::fromStdString(_window), true);
 	for (auto &window : windowList) {
-		try {
-			std::regex expr(_window);
-			if (!std::regex_match(window, expr)) {
-				continue;
-			}
-		} catch (const std::regex_error &) {
+		if (expr.isValid() &&
+		    !expr.match(QString::fromStdString(window)).hasMatch()) {
+			continue;
 		}
 
 		bool focus = (!_focus || window == currentWindowTitle);
@@ -55,8 +53,7 @@ bool foregroundWindowChanged()
 bool MacroConditionWindow::CheckCondition()
 {
 	std::string currentWindowTitle = switcher->currentTitle;
-	std::vector<std::string> windowList;
-	GetWindowList(windowList);
+	auto &windowList = switcher->getWindowList();
 
 	bool match = false;
 
@@ -72,6 +69,11 @@ bool MacroConditionWindow::CheckCondition()
 	return match;
 }
 
+bool MacroConditionWindow::RequiresPolling()
+{
+	return !WindowChangeEventsSupported();
+}
+
 bool MacroConditionWindow::Save(obs_data_t *obj)
 {
 	MacroCondition::Save(obj);
@@ -85,6 +85,22 @@ bool MacroCondition::Load(obs_data_t *obj)
 	return true;
 }
 
+bool MacroCondition::CheckConditionCached()
+{
+	size_t fingerprint = 0;
+	if (!GetInputFingerprint(fingerprint)) {
+		_cacheValid = false;
+		return CheckCondition();
+	}
+	if (_cacheValid && fingerprint == _lastFingerprint) {
+		return _lastResult;
+	}
+	_lastResult = CheckCondition();
+	_lastFingerprint = fingerprint;
+	_cacheValid = true;
+	return _lastResult;
+}
+
 void MacroCondition::ResetDuration()
 {
 	_duration.Reset();
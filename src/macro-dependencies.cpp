@@ -0,0 +1,44 @@
+#include "headers/macro-dependencies.hpp"
+
+#include <algorithm>
+#include <functional>
+
+std::vector<int>
+getMacroCheckLevels(const std::vector<MacroDependencies> &dependencies)
+{
+	enum class State { UNVISITED, VISITING, DONE };
+	std::vector<State> states(dependencies.size(), State::UNVISITED);
+	std::vector<int> levels(dependencies.size(), 0);
+
+	std::function<int(size_t)> getLevel = [&](size_t idx) {
+		if (states[idx] == State::DONE) {
+			return levels[idx];
+		}
+		if (states[idx] == State::VISITING) {
+			return -1;
+		}
+		states[idx] = State::VISITING;
+
+		int level = 0;
+		if (dependencies[idx].previousMacros) {
+			for (size_t i = 0; i < idx; i++) {
+				level = std::max(level, getLevel(i) + 1);
+			}
+		}
+		for (auto dep : dependencies[idx].macros) {
+			if (dep >= dependencies.size()) {
+				continue;
+			}
+			level = std::max(level, getLevel(dep) + 1);
+		}
+
+		states[idx] = State::DONE;
+		levels[idx] = level;
+		return level;
+	};
+
+	for (size_t i = 0; i < dependencies.size(); i++) {
+		getLevel(i);
+	}
+	return levels;
+}
@@ -10,6 +10,10 @@ void MacroProperties::Save(obs_data_t *obj)
 	obs_data_set_bool(data, "highlightExecuted", _highlightExecuted);
 	obs_data_set_bool(data, "highlightConditions", _highlightConditions);
 	obs_data_set_bool(data, "highlightActions", _highlightActions);
+	obs_data_set_bool(data, "shortCircuitEvaluation",
+			  _shortCircuitEvaluation);
+	obs_data_set_bool(data, "reorderConditions", _reorderConditions);
+	obs_data_set_bool(data, "concurrentEvaluation", _concurrentEvaluation);
 	obs_data_set_obj(obj, "macroProperties", data);
 	obs_data_release(data);
 }
@@ -27,6 +31,10 @@ void MacroProperties::Load(obs_data_t *obj)
 	}
 	_highlightConditions = obs_data_get_bool(data, "highlightConditions");
 	_highlightActions = obs_data_get_bool(data, "highlightActions");
+	_shortCircuitEvaluation =
+		obs_data_get_bool(data, "shortCircuitEvaluation");
+	_reorderConditions = obs_data_get_bool(data, "reorderConditions");
+	_concurrentEvaluation = obs_data_get_bool(data, "concurrentEvaluation");
 	obs_data_release(data);
 }
 
@@ -40,6 +48,12 @@ MacroPropertiesDialog::MacroPropertiesDialog(QWidget *parent,
 		  "AdvSceneSwitcher.macroTab.highlightTrueConditions"))),
 	  _actions(new QCheckBox(obs_module_text(
 		  "AdvSceneSwitcher.macroTab.highlightPerformedActions"))),
+	  _shortCircuit(new QCheckBox(obs_module_text(
+		  "AdvSceneSwitcher.macroTab.shortCircuitEvaluation"))),
+	  _reorder(new QCheckBox(obs_module_text(
+		  "AdvSceneSwitcher.macroTab.reorderConditions"))),
+	  _concurrent(new QCheckBox(obs_module_text(
+		  "AdvSceneSwitcher.macroTab.concurrentEvaluation"))),
 	  _hotkeys(new QCheckBox(
 		  obs_module_text("AdvSceneSwitcher.macroTab.disableHotkeys")))
 {
@@ -52,6 +66,16 @@ MacroPropertiesDialog::MacroPropertiesDialog(QWidget *parent,
 	_executed->setChecked(prop._highlightExecuted);
 	_conditions->setChecked(prop._highlightConditions);
 	_actions->setChecked(prop._highlightActions);
+	_shortCircuit->setChecked(prop._shortCircuitEvaluation);
+	_shortCircuit->setToolTip(obs_module_text(
+		"AdvSceneSwitcher.macroTab.shortCircuitEvaluation.tooltip"));
+	_reorder->setChecked(prop._reorderConditions);
+	_reorder->setEnabled(prop._shortCircuitEvaluation);
+	connect(_shortCircuit, &QCheckBox::toggled, _reorder,
+		&QCheckBox::setEnabled);
+	_concurrent->setChecked(prop._concurrentEvaluation);
+	_concurrent->setToolTip(obs_module_text(
+		"AdvSceneSwitcher.macroTab.concurrentEvaluation.tooltip"));
 	if (macro) {
 		_hotkeys->setChecked(macro->PauseHotkeysEnabled());
 	} else {
@@ -62,6 +86,9 @@ MacroPropertiesDialog::MacroPropertiesDialog(QWidget *parent,
 	layout->addWidget(_executed);
 	layout->addWidget(_conditions);
 	layout->addWidget(_actions);
+	layout->addWidget(_shortCircuit);
+	layout->addWidget(_reorder);
+	layout->addWidget(_concurrent);
 	layout->addWidget(_hotkeys);
 	setLayout(layout);
 
@@ -85,6 +112,9 @@ bool MacroPropertiesDialog::AskForSettings(QWidget *parent,
 	userInput._highlightExecuted = dialog._executed->isChecked();
 	userInput._highlightConditions = dialog._conditions->isChecked();
 	userInput._highlightActions = dialog._actions->isChecked();
+	userInput._shortCircuitEvaluation = dialog._shortCircuit->isChecked();
+	userInput._reorderConditions = dialog._reorder->isChecked();
+	userInput._concurrentEvaluation = dialog._concurrent->isChecked();
 	if (macro) {
 		macro->EnablePauseHotkeys(dialog._hotkeys->isChecked());
 	}
@@ -2,6 +2,8 @@
 #include "headers/macro-action-edit.hpp"
 #include "headers/macro-condition-edit.hpp"
 #include "headers/macro-action-scene-switch.hpp"
+#include "headers/macro-dependencies.hpp"
+#include "headers/audio-fade.hpp"
 #include "headers/advanced-scene-switcher.hpp"
 
 #include <limits>
@@ -11,6 +13,13 @@
 
 constexpr int perfLogThreshold = 300;
 
+static std::string getProfilerName(const std::string &macroName,
+				   MacroSegment *segment)
+{
+	return macroName + " - " + std::to_string(segment->GetIndex()) + ": " +
+	       segment->GetId();
+}
+
 Macro::Macro(const std::string &name, const bool addHotkey)
 {
 	SetName(name);
@@ -29,14 +38,26 @@ Macro::~Macro()
 bool Macro::CeckMatch()
 {
 	_matched = false;
+	if (_paused) {
+		vblog(LOG_INFO, "Macro %s is paused", _name.c_str());
+		return false;
+	}
+
+	_logicChain.Clear();
 	for (auto &c : _conditions) {
-		if (_paused) {
-			vblog(LOG_INFO, "Macro %s is paused", _name.c_str());
-			return false;
-		}
+		// Skipping conditions using duration modifiers would break
+		// the duration checks and skipping conditions with side effects
+		// would leave their state stale for the following checks
+		bool skippable = c->GetDurationModifier().GetType() ==
+					 DurationModifier::Type::NONE &&
+				 !c->HasCheckSideEffects();
+		_logicChain.Add(c->GetLogicType(), c->GetCost(), skippable);
+	}
 
+	auto checkCondition = [this](size_t idx) {
+		auto &c = _conditions[idx];
 		auto startTime = std::chrono::high_resolution_clock::now();
-		bool cond = c->CheckCondition();
+		bool cond = c->CheckConditionCached();
 		auto endTime = std::chrono::high_resolution_clock::now();
 		auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
 			endTime - startTime);
@@ -45,6 +66,14 @@ bool Macro::CeckMatch()
 			     "spent %ld ms in %s condition check of macro '%s'!",
 			     ms.count(), c->GetId().c_str(), Name().c_str());
 		}
+		if (switcher->profiler.Enabled()) {
+			switcher->profiler.AddSample(
+				ProfilerCategory::CONDITION,
+				getProfilerName(_name, c.get()),
+				std::chrono::duration<double, std::milli>(
+					endTime - startTime)
+					.count());
+		}
 
 		c->CheckDurationModifier(cond);
 
@@ -53,38 +82,17 @@ bool Macro::CeckMatch()
 			vblog(LOG_INFO,
 			      "ignoring condition check 'none' for '%s'",
 			      _name.c_str());
-			continue;
+			return cond;
 		case LogicType::AND:
-			_matched = _matched && cond;
-			if (cond) {
-				c->SetHighlight();
-			}
-			break;
 		case LogicType::OR:
-			_matched = _matched || cond;
+		case LogicType::ROOT_NONE:
 			if (cond) {
 				c->SetHighlight();
 			}
 			break;
 		case LogicType::AND_NOT:
-			_matched = _matched && !cond;
-			if (!cond) {
-				c->SetHighlight();
-			}
-			break;
 		case LogicType::OR_NOT:
-			if (!cond) {
-				c->SetHighlight();
-			}
-			break;
-		case LogicType::ROOT_NONE:
-			_matched = cond;
-			if (cond) {
-				c->SetHighlight();
-			}
-			break;
 		case LogicType::ROOT_NOT:
-			_matched = !cond;
 			if (!cond) {
 				c->SetHighlight();
 			}
@@ -97,7 +105,20 @@ bool Macro::CeckMatch()
 		}
 		vblog(LOG_INFO, "condition %s returned %d", c->GetId().c_str(),
 		      cond);
-	}
+		return cond;
+	};
+
+	auto skipCondition = [this](size_t idx) {
+		vblog(LOG_INFO, "skipping condition %s as result is known",
+		      _conditions[idx]->GetId().c_str());
+	};
+
+	const auto &props = switcher->macroProperties;
+	_matched = _logicChain.Evaluate(
+		props._shortCircuitEvaluation,
+		props._shortCircuitEvaluation && props._reorderConditions,
+		checkCondition, skipCondition);
+
 	vblog(LOG_INFO, "Macro %s returned %d", _name.c_str(), _matched);
 
 	bool newLastMatched = _matched;
@@ -172,7 +193,14 @@ void Macro::RunActions(bool &retVal, bool ignorePause)
 	bool ret = true;
 	for (auto &a : _actions) {
 		a->LogAction();
+		auto startTime = std::chrono::high_resolution_clock::now();
 		ret = ret && a->PerformAction();
+		if (switcher->profiler.Enabled()) {
+			switcher->profiler.AddSample(
+				ProfilerCategory::ACTION,
+				getProfilerName(_name, a.get()),
+				msSince(startTime));
+		}
 		if (!ret || (_paused && !ignorePause) || _stop || _die) {
 			retVal = ret;
 			break;
@@ -195,10 +223,45 @@ void Macro::SetOnChangeHighlight()
 
 void Macro::SetPaused(bool pause)
 {
-	if (_paused && !pause) {
+	bool unpaused = _paused && !pause;
+	if (unpaused) {
 		ResetTimers();
 	}
 	_paused = pause;
+	if (unpaused) {
+		switcher->Wakeup();
+	}
+}
+
+WakeupEvent Macro::GetWakeupEvents()
+{
+	WakeupEvent events = WakeupEvent::NONE;
+	for (auto &c : _conditions) {
+		events = events | c->GetWakeupEvents();
+	}
+	return events;
+}
+
+bool Macro::RequiresPolling()
+{
+	if (_paused) {
+		return false;
+	}
+
+	// Without "match on change" the actions have to be executed on each
+	// interval as long as the conditions are met
+	if (!_matchOnChange || _conditions.empty()) {
+		return true;
+	}
+
+	for (auto &c : _conditions) {
+		if (c->RequiresPolling() ||
+		    c->GetDurationModifier().GetType() !=
+			    DurationModifier::Type::NONE) {
+			return true;
+		}
+	}
+	return false;
 }
 
 void Macro::AddHelperThread(std::thread &&newThread)
@@ -216,6 +279,7 @@ void Macro::Stop()
 {
 	_stop = true;
 	switcher->macroWaitCv.notify_all();
+	AudioFade::Stop(this);
 	for (auto &t : _helperThreads) {
 		if (t.joinable()) {
 			t.join();
@@ -423,6 +487,39 @@ void Macro::ResolveMacroRef()
 	}
 }
 
+bool Macro::CanBeCheckedConcurrently()
+{
+	for (auto &c : _conditions) {
+		if (!c->CanBeCheckedConcurrently()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool Macro::DependsOnPreviousMacros()
+{
+	for (auto &c : _conditions) {
+		if (c->DependsOnPreviousMacros()) {
+			return true;
+		}
+	}
+	return false;
+}
+
+std::vector<Macro *> Macro::GetReferencedMacros()
+{
+	std::vector<Macro *> macros;
+	for (auto &c : _conditions) {
+		MacroRefCondition *ref =
+			dynamic_cast<MacroRefCondition *>(c.get());
+		if (ref && ref->_macro.get()) {
+			macros.push_back(ref->_macro.get());
+		}
+	}
+	return macros;
+}
+
 bool Macro::SwitchesScene()
 {
 	MacroActionSwitchScene temp(nullptr);
@@ -607,8 +704,94 @@ void SwitcherData::loadMacros(obs_data_t *obj)
 	}
 }
 
+static std::vector<MacroDependencies>
+getMacroDependencies(std::deque<std::shared_ptr<Macro>> &macros)
+{
+	std::unordered_map<Macro *, size_t> indices;
+	for (size_t i = 0; i < macros.size(); i++) {
+		indices[macros[i].get()] = i;
+	}
+
+	std::vector<MacroDependencies> dependencies(macros.size());
+	for (size_t i = 0; i < macros.size(); i++) {
+		dependencies[i].previousMacros =
+			macros[i]->DependsOnPreviousMacros();
+		for (auto ref : macros[i]->GetReferencedMacros()) {
+			auto it = indices.find(ref);
+			if (it != indices.end()) {
+				dependencies[i].macros.push_back(it->second);
+			}
+		}
+	}
+	return dependencies;
+}
+
+// Macros referring to other macros have to be checked after the macros they
+// refer to. So each macro is assigned a level and all macros of a level are
+// only checked once all macros of the previous levels have been checked.
+const std::vector<int> &SwitcherData::getMacroCheckLevels()
+{
+	// Collecting the dependencies is cheap compared to resolving them, so
+	// the levels are only resolved again if the dependencies changed
+	auto dependencies = getMacroDependencies(macros);
+	if (dependencies != macroDependencies ||
+	    macroCheckLevels.size() != macros.size()) {
+		macroCheckLevels = ::getMacroCheckLevels(dependencies);
+		macroDependencies = std::move(dependencies);
+	}
+	return macroCheckLevels;
+}
+
+bool SwitcherData::checkMacrosConcurrently()
+{
+	bool ret = false;
+	const auto &levels = getMacroCheckLevels();
+	int maxLevel = -1;
+	for (auto level : levels) {
+		maxLevel = std::max(maxLevel, level);
+	}
+
+	std::vector<Macro *> serialMacros;
+	for (int level = 0; level <= maxLevel; level++) {
+		for (size_t i = 0; i < macros.size(); i++) {
+			if (levels[i] != level) {
+				continue;
+			}
+			auto macro = macros[i].get();
+			if (macro->CanBeCheckedConcurrently()) {
+				macroThreadPool.start(
+					Compatability::CreateFunctionRunnable(
+						[macro]() { macro->CeckMatch(); }));
+			} else {
+				serialMacros.push_back(macro);
+			}
+		}
+
+		for (auto macro : serialMacros) {
+			macro->CeckMatch();
+		}
+		serialMacros.clear();
+		macroThreadPool.waitForDone();
+
+		for (size_t i = 0; i < macros.size(); i++) {
+			if (levels[i] != level || !macros[i]->Matched()) {
+				continue;
+			}
+			ret = true;
+			if (macros[i]->SwitchesScene()) {
+				macroSceneSwitched = true;
+			}
+		}
+	}
+	return ret;
+}
+
 bool SwitcherData::checkMacros()
 {
+	if (macroProperties._concurrentEvaluation) {
+		return checkMacrosConcurrently();
+	}
+
 	bool ret = false;
 	for (auto &m : macros) {
 		if (m->CeckMatch()) {
@@ -9,6 +9,7 @@
 #include <vector>
 #include <QStringList>
 #include <QRegularExpression>
+#include "../headers/regex-cache.hpp"
 #include <map>
 #include <thread>
 
@@ -161,7 +162,7 @@ bool isWindowMaximizedOnScreen(NSDictionary *app, NSScreen *screen)
 bool nameMachesPattern(std::string windowName, std::string pattern)
 {
 	return QString::fromStdString(windowName)
-		.contains(QRegularExpression(QString::fromStdString(pattern)));
+		.contains(getRegex(QString::fromStdString(pattern)));
 }
 
 bool isMaximized(const std::string &title)
@@ -297,11 +298,16 @@ bool isInFocus(const QString &executable)
 	bool equals = (executable.toStdString() == current);
 	// True if executable switch matches current window
 	bool matches = QString::fromStdString(current).contains(
-		QRegularExpression(executable));
+		getRegex(executable));
 
 	return (equals || matches);
 }
 
+bool WindowChangeEventsSupported()
+{
+	return false;
+}
+
 static std::map<HotkeyType, CGKeyCode> keyTable = {
 	// Chars
 	{HotkeyType::Key_A, kVK_ANSI_A},
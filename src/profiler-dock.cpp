@@ -0,0 +1,178 @@
+#include "headers/profiler-dock.hpp"
+#include "headers/advanced-scene-switcher.hpp"
+#include "headers/utility.hpp"
+
+#include <obs-module.h>
+#include <obs-frontend-api.h>
+#include <QMainWindow>
+#include <QLayout>
+#include <QAction>
+#include <QFileDialog>
+#include <QHeaderView>
+#include <QTextStream>
+
+ProfilerDock *profilerDock = nullptr;
+
+static QString getCategoryName(ProfilerCategory category)
+{
+	switch (category) {
+	case ProfilerCategory::TICK:
+		return obs_module_text("AdvSceneSwitcher.profiler.type.tick");
+	case ProfilerCategory::LOCK_WAIT:
+		return obs_module_text(
+			"AdvSceneSwitcher.profiler.type.lockWait");
+	case ProfilerCategory::CONDITION:
+		return obs_module_text(
+			"AdvSceneSwitcher.profiler.type.condition");
+	case ProfilerCategory::ACTION:
+		return obs_module_text("AdvSceneSwitcher.profiler.type.action");
+	case ProfilerCategory::LEGACY_SWITCH:
+		return obs_module_text(
+			"AdvSceneSwitcher.profiler.type.legacySwitch");
+	default:
+		break;
+	}
+	return "";
+}
+
+static QTableWidgetItem *createNumberItem(double value)
+{
+	auto item = new QTableWidgetItem();
+	item->setData(Qt::DisplayRole, value);
+	return item;
+}
+
+ProfilerWidget::ProfilerWidget(QWidget *parent)
+	: QWidget(parent),
+	  _enable(new QCheckBox(
+		  obs_module_text("AdvSceneSwitcher.profiler.enable"))),
+	  _reset(new QPushButton(
+		  obs_module_text("AdvSceneSwitcher.profiler.reset"))),
+	  _export(new QPushButton(
+		  obs_module_text("AdvSceneSwitcher.profiler.export"))),
+	  _table(new QTableWidget(0, 6))
+{
+	_table->setHorizontalHeaderLabels(
+		{obs_module_text("AdvSceneSwitcher.profiler.column.type"),
+		 obs_module_text("AdvSceneSwitcher.profiler.column.name"),
+		 obs_module_text("AdvSceneSwitcher.profiler.column.count"),
+		 obs_module_text("AdvSceneSwitcher.profiler.column.p50"),
+		 obs_module_text("AdvSceneSwitcher.profiler.column.p95"),
+		 obs_module_text("AdvSceneSwitcher.profiler.column.max")});
+	_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+	_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+	_table->verticalHeader()->hide();
+	_table->horizontalHeader()->setSectionResizeMode(
+		1, QHeaderView::Stretch);
+	_table->setSortingEnabled(true);
+
+	_enable->setChecked(switcher->profiler.Enabled());
+
+	QWidget::connect(_enable, SIGNAL(stateChanged(int)), this,
+			 SLOT(EnableChanged(int)));
+	QWidget::connect(_reset, SIGNAL(clicked()), this,
+			 SLOT(ResetClicked()));
+	QWidget::connect(_export, SIGNAL(clicked()), this,
+			 SLOT(ExportClicked()));
+
+	QHBoxLayout *controlsLayout = new QHBoxLayout();
+	controlsLayout->addWidget(_enable);
+	controlsLayout->addStretch();
+	controlsLayout->addWidget(_reset);
+	controlsLayout->addWidget(_export);
+	QVBoxLayout *layout = new QVBoxLayout();
+	layout->addLayout(controlsLayout);
+	layout->addWidget(_table);
+	setLayout(layout);
+
+	connect(&_timer, SIGNAL(timeout()), this, SLOT(UpdateTable()));
+	_timer.start(1000);
+}
+
+void ProfilerWidget::EnableChanged(int state)
+{
+	switcher->profiler.SetEnabled(state);
+}
+
+void ProfilerWidget::ResetClicked()
+{
+	switcher->profiler.Reset();
+	UpdateTable();
+}
+
+void ProfilerWidget::ExportClicked()
+{
+	QString selectedFilter;
+	QString path = QFileDialog::getSaveFileName(
+		this, obs_module_text("AdvSceneSwitcher.profiler.export"),
+		QDir::currentPath(), "CSV (*.csv);;JSON (*.json)",
+		&selectedFilter);
+	if (path.isEmpty()) {
+		return;
+	}
+
+	QFile file(path);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+		DisplayMessage(obs_module_text(
+			"AdvSceneSwitcher.profiler.exportFailed"));
+		return;
+	}
+
+	bool json = path.endsWith(".json", Qt::CaseInsensitive) ||
+		    (!path.endsWith(".csv", Qt::CaseInsensitive) &&
+		     selectedFilter.startsWith("JSON"));
+	auto data = json ? switcher->profiler.ToJSON()
+			 : switcher->profiler.ToCSV();
+	QTextStream out(&file);
+	out << QString::fromStdString(data);
+}
+
+void ProfilerWidget::UpdateTable()
+{
+	if (!switcher || !isVisible()) {
+		return;
+	}
+
+	auto entries = switcher->profiler.GetEntries();
+	_table->setSortingEnabled(false);
+	_table->setRowCount(static_cast<int>(entries.size()));
+	for (int row = 0; row < (int)entries.size(); row++) {
+		const auto &e = entries[row];
+		_table->setItem(row, 0,
+				new QTableWidgetItem(
+					getCategoryName(e.category)));
+		_table->setItem(row, 1,
+				new QTableWidgetItem(
+					QString::fromStdString(e.name)));
+		_table->setItem(row, 2, createNumberItem(e.stats.count));
+		_table->setItem(row, 3, createNumberItem(e.stats.p50));
+		_table->setItem(row, 4, createNumberItem(e.stats.p95));
+		_table->setItem(row, 5, createNumberItem(e.stats.max));
+	}
+	_table->setSortingEnabled(true);
+}
+
+ProfilerDock::ProfilerDock(QWidget *parent)
+	: QDockWidget(obs_module_text("AdvSceneSwitcher.profiler.title"),
+		      parent)
+{
+	setFloating(true);
+	// Setting a fixed object name is crucial for OBS to be able to restore
+	// the docks position, if the dock is not floating
+	setObjectName("Adv-ss-profiler-dock");
+
+	QWidget *tmp = new QWidget;
+	QHBoxLayout *layout = new QHBoxLayout;
+	layout->addWidget(new ProfilerWidget(this));
+	tmp->setLayout(layout);
+	setWidget(tmp);
+}
+
+void SetupProfilerDock()
+{
+	profilerDock = new ProfilerDock(
+		static_cast<QMainWindow *>(obs_frontend_get_main_window()));
+	// Added for cosmetic reasons to avoid brief flash of dock window on startup
+	profilerDock->setVisible(false);
+	obs_frontend_add_dock(profilerDock);
+}
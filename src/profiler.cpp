@@ -0,0 +1,166 @@
+#include "headers/profiler.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+void ProfilerSampleWindow::Add(double ms)
+{
+	if (_samples.size() < profiler_window_size) {
+		_samples.push_back(ms);
+	} else {
+		_samples[_next] = ms;
+	}
+	_next = (_next + 1) % profiler_window_size;
+	_count++;
+}
+
+static double getPercentile(std::vector<double> &samples, double percentile)
+{
+	size_t idx = static_cast<size_t>(percentile * (samples.size() - 1));
+	std::nth_element(samples.begin(), samples.begin() + idx, samples.end());
+	return samples[idx];
+}
+
+ProfilerStats ProfilerSampleWindow::GetStats() const
+{
+	ProfilerStats stats;
+	stats.count = _count;
+	if (_samples.empty()) {
+		return stats;
+	}
+	auto samples = _samples;
+	stats.p50 = getPercentile(samples, 0.5);
+	stats.p95 = getPercentile(samples, 0.95);
+	stats.max = *std::max_element(samples.begin(), samples.end());
+	return stats;
+}
+
+void Profiler::AddSample(ProfilerCategory category, const std::string &name,
+			 double ms)
+{
+	if (!_enabled) {
+		return;
+	}
+	std::lock_guard<std::mutex> lock(_mutex);
+	_windows[{category, name}].Add(ms);
+}
+
+void Profiler::Reset()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_windows.clear();
+}
+
+std::vector<Profiler::Entry> Profiler::GetEntries()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	std::vector<Entry> entries;
+	entries.reserve(_windows.size());
+	for (const auto &w : _windows) {
+		entries.push_back(
+			{w.first.first, w.first.second, w.second.GetStats()});
+	}
+	return entries;
+}
+
+static std::string escapeCSV(const std::string &str)
+{
+	std::string result = "\"";
+	for (const char c : str) {
+		if (c == '"') {
+			result += '"';
+		}
+		result += c;
+	}
+	return result + "\"";
+}
+
+static std::string escapeJSON(const std::string &str)
+{
+	std::string result = "\"";
+	for (const char c : str) {
+		switch (c) {
+		case '"':
+			result += "\\\"";
+			break;
+		case '\\':
+			result += "\\\\";
+			break;
+		case '\n':
+			result += "\\n";
+			break;
+		case '\t':
+			result += "\\t";
+			break;
+		default:
+			if (static_cast<unsigned char>(c) < 0x20) {
+				char buf[8];
+				snprintf(buf, sizeof(buf), "\\u%04x", c);
+				result += buf;
+			} else {
+				result += c;
+			}
+			break;
+		}
+	}
+	return result + "\"";
+}
+
+static std::string formatMs(double ms)
+{
+	char buf[32];
+	snprintf(buf, sizeof(buf), "%.3f", ms);
+	return buf;
+}
+
+std::string Profiler::ToCSV()
+{
+	std::string csv = "category,name,count,p50_ms,p95_ms,max_ms\n";
+	for (const auto &e : GetEntries()) {
+		csv += std::string(getProfilerCategoryName(e.category)) + "," +
+		       escapeCSV(e.name) + "," + std::to_string(e.stats.count) +
+		       "," + formatMs(e.stats.p50) + "," +
+		       formatMs(e.stats.p95) + "," + formatMs(e.stats.max) +
+		       "\n";
+	}
+	return csv;
+}
+
+std::string Profiler::ToJSON()
+{
+	std::string json = "[";
+	bool first = true;
+	for (const auto &e : GetEntries()) {
+		if (!first) {
+			json += ",";
+		}
+		first = false;
+		json += "\n  {\"category\": " +
+			escapeJSON(getProfilerCategoryName(e.category)) +
+			", \"name\": " + escapeJSON(e.name) +
+			", \"count\": " + std::to_string(e.stats.count) +
+			", \"p50_ms\": " + formatMs(e.stats.p50) +
+			", \"p95_ms\": " + formatMs(e.stats.p95) +
+			", \"max_ms\": " + formatMs(e.stats.max) + "}";
+	}
+	return json + "\n]\n";
+}
+
+const char *getProfilerCategoryName(ProfilerCategory category)
+{
+	switch (category) {
+	case ProfilerCategory::TICK:
+		return "tick";
+	case ProfilerCategory::LOCK_WAIT:
+		return "lock_wait";
+	case ProfilerCategory::CONDITION:
+		return "condition";
+	case ProfilerCategory::ACTION:
+		return "action";
+	case ProfilerCategory::LEGACY_SWITCH:
+		return "legacy_switch";
+	default:
+		break;
+	}
+	return "unknown";
+}
@@ -0,0 +1,55 @@
+#include "headers/regex-cache.hpp"
+
+#include <QHash>
+#include <QPair>
+#include <mutex>
+
+// Patterns are only changed by the user, so there should be no need to ever
+// evict entries unless something unexpected happens
+constexpr int regex_cache_size = 1000;
+
+static std::mutex mutex;
+static QHash<QPair<QString, bool>, QRegularExpression> cache;
+
+QRegularExpression getRegex(const QString &pattern, bool fullMatch)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	auto key = qMakePair(pattern, fullMatch);
+	auto it = cache.constFind(key);
+	if (it != cache.constEnd()) {
+		return it.value();
+	}
+
+	if (cache.size() >= regex_cache_size) {
+		cache.clear();
+	}
+
+	QRegularExpression expr(fullMatch ? "\\A(?:" + pattern + ")\\z"
+					  : pattern);
+	expr.optimize();
+	cache.insert(key, expr);
+	return expr;
+}
+
+bool matchRegex(const std::string &str, const std::string &pattern)
+{
+	auto expr = getRegex(QString::fromStdString(pattern), true);
+	if (!expr.isValid()) {
+		return false;
+	}
+	return expr.match(QString::fromStdString(str)).hasMatch();
+}
+
+bool containsRegexMatch(const QStringList &list, const QString &pattern)
+{
+	auto expr = getRegex(pattern, true);
+	if (!expr.isValid()) {
+		return false;
+	}
+	for (const auto &str : list) {
+		if (expr.match(str).hasMatch()) {
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,195 @@
+#include "headers/source-capture.hpp"
+#include "headers/advanced-scene-switcher.hpp"
+
+#include <cstring>
+#include <map>
+
+static std::mutex registryMutex;
+typedef std::pair<obs_weak_source_t *, CaptureSettings> CaptureKey;
+static std::map<CaptureKey, std::weak_ptr<SourceCapture>> registry;
+
+std::shared_ptr<SourceCapture> SourceCapture::Get(const OBSWeakSource &source,
+						  const CaptureSettings &settings)
+{
+	std::lock_guard<std::mutex> lock(registryMutex);
+	CaptureKey key(source, settings);
+	auto it = registry.find(key);
+	if (it != registry.end()) {
+		if (auto capture = it->second.lock()) {
+			return capture;
+		}
+	}
+
+	std::shared_ptr<SourceCapture> capture(
+		new SourceCapture(source, settings));
+	registry[key] = capture;
+	return capture;
+}
+
+SourceCapture::SourceCapture(const OBSWeakSource &source,
+			     const CaptureSettings &settings)
+	: _source(source), _settings(settings)
+{
+	obs_add_tick_callback(Tick, this);
+}
+
+SourceCapture::~SourceCapture()
+{
+	obs_remove_tick_callback(Tick, this);
+
+	obs_enter_graphics();
+	gs_stagesurface_destroy(_stagesurfs[0]);
+	gs_stagesurface_destroy(_stagesurfs[1]);
+	gs_texrender_destroy(_texrender);
+	obs_leave_graphics();
+
+	std::lock_guard<std::mutex> lock(registryMutex);
+	auto it = registry.find(CaptureKey(_source, _settings));
+	if (it != registry.end() && it->second.expired()) {
+		registry.erase(it);
+	}
+}
+
+SourceCapture::Frame SourceCapture::GetFrame()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _frame;
+}
+
+void SourceCapture::Tick(void *param, float)
+{
+	auto capture = reinterpret_cast<SourceCapture *>(param);
+	if (!capture->_requested && capture->_pendingSurface < 0) {
+		return;
+	}
+
+	obs_enter_graphics();
+
+	// Download the capture staged during the previous video frame
+	if (capture->_pendingSurface >= 0) {
+		capture->Copy(capture->_stagesurfs[capture->_pendingSurface]);
+		capture->_pendingSurface = -1;
+	}
+
+	if (capture->_requested.exchange(false) && capture->Render()) {
+		auto &surface = capture->_stagesurfs[capture->_nextSurface];
+		gs_stage_texture(surface,
+				 gs_texrender_get_texture(capture->_texrender));
+		capture->_pendingSurface = capture->_nextSurface;
+		capture->_nextSurface ^= 1;
+	}
+
+	obs_leave_graphics();
+}
+
+bool SourceCapture::Render()
+{
+	OBSSource source = OBSGetStrongRef(_source);
+	uint32_t cx, cy;
+	if (source) {
+		cx = obs_source_get_base_width(source);
+		cy = obs_source_get_base_height(source);
+	} else {
+		obs_video_info ovi;
+		obs_get_video_info(&ovi);
+		cx = ovi.base_width;
+		cy = ovi.base_height;
+	}
+
+	if (!cx || !cy) {
+		vblog(LOG_WARNING,
+		      "Cannot screenshot \"%s\", invalid target size",
+		      obs_source_get_name(source));
+		QImage empty;
+		PublishFrame(empty);
+		return false;
+	}
+
+	float left = 0.f, top = 0.f, width = (float)cx, height = (float)cy;
+	if (_settings.width > 0 && _settings.height > 0) {
+		left = (float)_settings.x;
+		top = (float)_settings.y;
+		width = (float)_settings.width;
+		height = (float)_settings.height;
+	}
+	cx = (uint32_t)(width * _settings.scale + 0.5);
+	cy = (uint32_t)(height * _settings.scale + 0.5);
+	if (!cx || !cy) {
+		QImage empty;
+		PublishFrame(empty);
+		return false;
+	}
+
+	if (cx != _cx || cy != _cy) {
+		gs_stagesurface_destroy(_stagesurfs[0]);
+		gs_stagesurface_destroy(_stagesurfs[1]);
+		_stagesurfs[0] = gs_stagesurface_create(cx, cy, GS_RGBA);
+		_stagesurfs[1] = gs_stagesurface_create(cx, cy, GS_RGBA);
+		_pendingSurface = -1;
+		_cx = cx;
+		_cy = cy;
+	}
+	if (!_texrender) {
+		_texrender = gs_texrender_create(GS_RGBA, GS_ZS_NONE);
+	}
+
+	gs_texrender_reset(_texrender);
+	if (!gs_texrender_begin(_texrender, cx, cy)) {
+		return false;
+	}
+
+	vec4 zero;
+	vec4_zero(&zero);
+
+	gs_clear(GS_CLEAR_COLOR, &zero, 0.0f, 0);
+	gs_ortho(left, left + width, top, top + height, -100.0f, 100.0f);
+
+	gs_blend_state_push();
+	gs_blend_function(GS_BLEND_ONE, GS_BLEND_ZERO);
+
+	if (source) {
+		obs_source_inc_showing(source);
+		obs_source_video_render(source);
+		obs_source_dec_showing(source);
+	} else {
+		obs_render_main_texture();
+	}
+
+	gs_blend_state_pop();
+	gs_texrender_end(_texrender);
+	return true;
+}
+
+void SourceCapture::Copy(gs_stagesurf_t *surface)
+{
+	uint8_t *videoData = nullptr;
+	uint32_t videoLinesize = 0;
+	if (!gs_stagesurface_map(surface, &videoData, &videoLinesize)) {
+		return;
+	}
+
+	// Reuse the frame buffer unless users of the capture still hold on
+	// to the frame, which was previously stored in it
+	auto &image = _buffers[_nextBuffer];
+	if (image.width() != (int)_cx || image.height() != (int)_cy) {
+		image = QImage(_cx, _cy, QImage::Format::Format_RGBA8888);
+	}
+
+	int linesize = image.bytesPerLine();
+	for (int y = 0; y < (int)_cy; y++) {
+		memcpy(image.scanLine(y), videoData + (y * videoLinesize),
+		       linesize);
+	}
+	gs_stagesurface_unmap(surface);
+
+	PublishFrame(image);
+	_nextBuffer ^= 1;
+}
+
+void SourceCapture::PublishFrame(QImage &image)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_frame.image = image;
+	_frame.sequence++;
+	_frame.time = std::chrono::high_resolution_clock::now();
+}
@@ -1,5 +1,6 @@
 #include "headers/advanced-scene-switcher.hpp"
 #include "headers/utility.hpp"
+#include "headers/regex-cache.hpp"
 
 bool ExecutableSwitch::pause = false;
 static QMetaObject::Connection addPulse;
@@ -85,27 +86,26 @@ bool SwitcherData::checkExeSwitch(OBSWeakSource &scene,
 	}
 
 	std::string title = switcher->currentTitle;
-	QStringList runningProcesses;
 	bool ignored = false;
 	bool match = false;
 
 	// Check for match
-	GetProcessList(runningProcesses);
+	auto &runningProcesses = getProcessList();
 	for (ExecutableSwitch &s : executableSwitches) {
 		if (!s.initialized()) {
 			continue;
 		}
 
-		bool equals = runningProcesses.contains(s.exe);
-		bool matches = (runningProcesses.indexOf(
-					QRegularExpression(s.exe)) != -1);
+		bool equals = isProcessRunning(s.exe);
+		bool matches = !equals &&
+			       containsRegexMatch(runningProcesses, s.exe);
 		bool focus = (!s.inFocus || isInFocus(s.exe));
 
 		// True if current window is ignored AND switch equals OR matches last window
 		bool ignore =
 			(ignored && (title == s.exe.toStdString() ||
 				     QString::fromStdString(title).contains(
-					     QRegularExpression(s.exe))));
+					     getRegex(s.exe))));
 
 		if ((equals || matches) && (focus || ignore)) {
 			match = true;
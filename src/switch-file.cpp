@@ -2,10 +2,9 @@
 #include <QTextStream>
 #include <QDateTime>
 #include <functional>
-#include <curl/curl.h>
 
 #include "headers/advanced-scene-switcher.hpp"
-#include "headers/curl-helper.hpp"
+#include "headers/http-fetcher.hpp"
 #include "headers/utility.hpp"
 
 bool FileSwitch::pause = false;
@@ -157,35 +156,6 @@ bool SwitcherData::checkSwitchInfoFromFile(OBSWeakSource &scene,
 	return match;
 }
 
-static size_t WriteCallback(void *contents, size_t size, size_t nmemb,
-			    void *userp)
-{
-	((std::string *)userp)->append((char *)contents, size * nmemb);
-	return size * nmemb;
-}
-
-static std::string getRemoteData(std::string &url)
-{
-	std::string readBuffer;
-
-	if (switcher->curl && f_curl_setopt && f_curl_perform) {
-		f_curl_setopt(switcher->curl, CURLOPT_URL, url.c_str());
-		f_curl_setopt(switcher->curl, CURLOPT_WRITEFUNCTION,
-			      WriteCallback);
-		f_curl_setopt(switcher->curl, CURLOPT_WRITEDATA, &readBuffer);
-
-		// Set timeout to at least one second
-		int timeout = switcher->interval / 1000;
-		if (timeout == 0) {
-			timeout = 1;
-		}
-		f_curl_setopt(switcher->curl, CURLOPT_TIMEOUT, 1);
-
-		f_curl_perform(switcher->curl);
-	}
-	return readBuffer;
-}
-
 bool matchFileContent(QString &filedata, FileSwitch &s)
 {
 	if (s.onlyMatchIfChanged) {
@@ -207,8 +177,12 @@ bool matchFileContent(QString &filedata, FileSwitch &s)
 
 bool checkRemoteFileContent(FileSwitch &s)
 {
-	std::string data = getRemoteData(s.file);
-	QString qdata = QString::fromStdString(data);
+	auto response = HttpFetcher::Get(
+		s.file, std::chrono::milliseconds(switcher->interval));
+	if (response.version == 0) {
+		return false;
+	}
+	QString qdata = QString::fromStdString(response.data);
 	return matchFileContent(qdata, s);
 }
 
@@ -1,7 +1,6 @@
-#include <regex>
-
 #include "headers/advanced-scene-switcher.hpp"
 #include "headers/utility.hpp"
+#include "headers/regex-cache.hpp"
 
 bool IdleData::pause = false;
 IdleWidget *idleWidget = nullptr;
@@ -26,14 +25,9 @@ bool SwitcherData::checkIdleSwitch(OBSWeakSource &scene,
 
 	if (!ignoreIdle) {
 		for (std::string &window : ignoreIdleWindows) {
-			try {
-				bool matches = std::regex_match(
-					title, std::regex(window));
-				if (matches) {
-					ignoreIdle = true;
-					break;
-				}
-			} catch (const std::regex_error &) {
+			if (matchRegex(title, window)) {
+				ignoreIdle = true;
+				break;
 			}
 		}
 	}
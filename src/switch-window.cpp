@@ -1,7 +1,6 @@
-#include <regex>
-
 #include "headers/advanced-scene-switcher.hpp"
 #include "headers/utility.hpp"
+#include "headers/regex-cache.hpp"
 
 bool WindowSwitch::pause = false;
 static QMetaObject::Connection addPulse;
@@ -189,17 +188,15 @@ void checkWindowTitleSwitchDirect(WindowSwitch &s,
 
 void checkWindowTitleSwitchRegex(WindowSwitch &s,
 				 std::string &currentWindowTitle,
-				 std::vector<std::string> windowList,
+				 const std::vector<std::string> &windowList,
 				 bool &match, OBSWeakSource &scene,
 				 OBSWeakSource &transition)
 {
+	auto expr = getRegex(QString::fromStdString(s.window), true);
 	for (auto &window : windowList) {
-		try {
-			std::regex expr(s.window);
-			if (!std::regex_match(window, expr)) {
-				continue;
-			}
-		} catch (const std::regex_error &) {
+		if (expr.isValid() &&
+		    !expr.match(QString::fromStdString(window)).hasMatch()) {
+			continue;
 		}
 
 		bool focus = (!s.focus || window == currentWindowTitle);
@@ -223,8 +220,7 @@ bool SwitcherData::checkWindowTitleSwitch(OBSWeakSource &scene,
 
 	std::string currentWindowTitle = switcher->currentTitle;
 	bool match = false;
-	std::vector<std::string> windowList;
-	GetWindowList(windowList);
+	auto &windowList = getWindowList();
 
 	for (WindowSwitch &s : windowSwitches) {
 		if (!s.initialized()) {
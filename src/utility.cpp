@@ -1,6 +1,7 @@
 #include "headers/utility.hpp"
 #include "headers/platform-funcs.hpp"
 #include "headers/scene-selection.hpp"
+#include "headers/regex-cache.hpp"
 
 #include <QTextStream>
 #include <QLabel>
@@ -347,12 +348,7 @@ bool matchJson(const std::string &json1, const std::string &json2,
 	}
 
 	if (useRegex) {
-		try {
-			std::regex expr(j2);
-			ret = std::regex_match(
-				j1, expr, std::regex_constants::match_default);
-		} catch (const std::regex_error &) {
-		}
+		ret = matchRegex(j1, j2);
 	} else {
 		ret = j1 == j2;
 	}
@@ -388,7 +384,7 @@ QString formatJsonString(QString json)
 
 QString escapeForRegex(QString &s)
 {
-	std::regex specialChars{R"([-[\]{}()*+?.,\^$|#\s])"};
+	static const std::regex specialChars{R"([-[\]{}()*+?.,\^$|#\s])"};
 	std::string input = s.toStdString();
 	return QString::fromStdString(
 		std::regex_replace(input, specialChars, R"(\$&)"));
@@ -1020,3 +1016,8 @@ bool doubleEquals(double left, double right, double epsilon)
 {
 	return (fabs(left - right) < epsilon);
 }
+
+void hashCombine(size_t &seed, size_t value)
+{
+	seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
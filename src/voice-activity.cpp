@@ -0,0 +1,264 @@
+#include "headers/voice-activity.hpp"
+#include "headers/advanced-scene-switcher.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+
+// Frames are classified as speech if they are louder than this level and
+// exceed the noise floor by the given margin
+constexpr double minSpeechLevel = -50.;
+constexpr double noiseFloorMargin = 10.;
+constexpr double minNoiseFloor = -90.;
+// Voiced and unvoiced speech roughly stays within this range, while clicks and
+// broadband noise cross zero much more often
+constexpr double minZeroCrossingRate = 50.;
+constexpr double maxZeroCrossingRate = 5000.;
+// Speech is reported once at least 5 of the last 8 frames contained speech
+constexpr uint32_t onsetFrameMask = 0xFF;
+constexpr int onsetFrameCount = 5;
+// Number of frames without speech until silence is reported again
+constexpr int hangoverFrames = 30;
+
+static std::mutex registryMutex;
+static std::map<obs_weak_source_t *, std::weak_ptr<VoiceActivityDetector>>
+	registry;
+
+static std::mutex workerMutex;
+static std::condition_variable workerCV;
+static std::thread worker;
+// Each worker thread has its own flag, so a new worker can already be started
+// while the previous one is still shutting down
+static std::shared_ptr<bool> stopWorker;
+static std::vector<VoiceActivityDetector *> detectors;
+
+static int64_t now()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		       std::chrono::high_resolution_clock::now()
+			       .time_since_epoch())
+		.count();
+}
+
+std::shared_ptr<VoiceActivityDetector>
+VoiceActivityDetector::Get(const OBSWeakSource &source)
+{
+	if (!source) {
+		return nullptr;
+	}
+
+	std::lock_guard<std::mutex> lock(registryMutex);
+	auto it = registry.find(source);
+	if (it != registry.end()) {
+		if (auto detector = it->second.lock()) {
+			return detector;
+		}
+	}
+
+	std::shared_ptr<VoiceActivityDetector> detector(
+		new VoiceActivityDetector(source));
+	registry[source] = detector;
+	return detector;
+}
+
+void VoiceActivityDetector::RunWorker(std::shared_ptr<bool> stop)
+{
+	std::unique_lock<std::mutex> lock(workerMutex);
+	while (!*stop) {
+		for (auto detector : detectors) {
+			detector->Process();
+		}
+		workerCV.wait_for(lock, std::chrono::milliseconds(10));
+	}
+}
+
+VoiceActivityDetector::VoiceActivityDetector(const OBSWeakSource &source)
+	: _source(source), _stateChangeTime(now())
+{
+	{
+		std::lock_guard<std::mutex> lock(workerMutex);
+		detectors.push_back(this);
+		if (!worker.joinable()) {
+			stopWorker = std::make_shared<bool>(false);
+			worker = std::thread(RunWorker, stopWorker);
+		}
+	}
+
+	obs_source_t *as = obs_weak_source_get_source(source);
+	obs_source_add_audio_capture_callback(as, ProcessAudio, this);
+	obs_source_release(as);
+}
+
+VoiceActivityDetector::~VoiceActivityDetector()
+{
+	obs_source_t *as = obs_weak_source_get_source(_source);
+	obs_source_remove_audio_capture_callback(as, ProcessAudio, this);
+	obs_source_release(as);
+
+	std::thread stoppedWorker;
+	{
+		std::lock_guard<std::mutex> lock(workerMutex);
+		detectors.erase(std::remove(detectors.begin(), detectors.end(),
+					    this),
+				detectors.end());
+		if (detectors.empty()) {
+			*stopWorker = true;
+			stoppedWorker = std::move(worker);
+		}
+	}
+	if (stoppedWorker.joinable()) {
+		workerCV.notify_all();
+		stoppedWorker.join();
+	}
+
+	std::lock_guard<std::mutex> lock(registryMutex);
+	auto it = registry.find(_source);
+	if (it != registry.end() && it->second.expired()) {
+		registry.erase(it);
+	}
+}
+
+std::chrono::milliseconds VoiceActivityDetector::GetStateDuration() const
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::nanoseconds(now() - _stateChangeTime));
+}
+
+void VoiceActivityDetector::ProcessAudio(void *data, obs_source_t *source,
+					 const struct audio_data *audio,
+					 bool muted)
+{
+	auto detector = static_cast<VoiceActivityDetector *>(data);
+
+	// Audio data is always passed on in the planar float format of the
+	// OBS audio output
+	const audio_output_info *info = audio_output_get_info(obs_get_audio());
+	detector->_sampleRate = info->samples_per_sec;
+	size_t channels = audio_output_get_channels(obs_get_audio());
+	if (channels > MAX_AUDIO_CHANNELS) {
+		channels = MAX_AUDIO_CHANNELS;
+	}
+	if (channels == 0) {
+		return;
+	}
+	const float volume = muted ? 0.f : obs_source_get_volume(source);
+
+	// Samples which do not fit into the buffer anymore are dropped, as
+	// only the worker thread is allowed to advance the read position
+	const size_t writePos = detector->_writePos.load(
+		std::memory_order_relaxed);
+	const size_t readPos =
+		detector->_readPos.load(std::memory_order_acquire);
+	size_t frames = _bufferSize - (writePos - readPos);
+	if (frames > audio->frames) {
+		frames = audio->frames;
+	}
+
+	const float *planes[MAX_AUDIO_CHANNELS] = {};
+	for (size_t ch = 0; ch < channels; ch++) {
+		planes[ch] = reinterpret_cast<const float *>(audio->data[ch]);
+	}
+
+	for (size_t i = 0; i < frames; i++) {
+		float sample = 0.f;
+		for (size_t ch = 0; ch < channels; ch++) {
+			if (planes[ch]) {
+				sample += planes[ch][i];
+			}
+		}
+		detector->_samples[(writePos + i) % _bufferSize] =
+			sample * volume / channels;
+	}
+	detector->_writePos.store(writePos + frames, std::memory_order_release);
+}
+
+void VoiceActivityDetector::Process()
+{
+	const uint32_t sampleRate = _sampleRate;
+	if (sampleRate == 0) {
+		return;
+	}
+
+	const size_t frameSize = sampleRate / 100;
+	if (_frame.size() != frameSize) {
+		_frame.resize(frameSize);
+		_frameFill = 0;
+	}
+
+	const size_t writePos = _writePos.load(std::memory_order_acquire);
+	size_t readPos = _readPos.load(std::memory_order_relaxed);
+	for (; readPos != writePos; readPos++) {
+		_frame[_frameFill++] = _samples[readPos % _bufferSize];
+		if (_frameFill == frameSize) {
+			ProcessFrame();
+			_frameFill = 0;
+		}
+	}
+	_readPos.store(readPos, std::memory_order_release);
+}
+
+void VoiceActivityDetector::ProcessFrame()
+{
+	double energy = 0.;
+	int zeroCrossings = 0;
+	for (size_t i = 0; i < _frame.size(); i++) {
+		energy += (double)_frame[i] * _frame[i];
+		if (i > 0 && (_frame[i] >= 0.f) != (_frame[i - 1] >= 0.f)) {
+			zeroCrossings++;
+		}
+	}
+	const double level = 10. * std::log10(energy / _frame.size() + 1e-12);
+	// Crossings per second, so it does not depend on the sample rate
+	const double zeroCrossingRate = zeroCrossings * 100.;
+
+	// The noise floor follows decreasing levels quickly, but only slowly
+	// adapts to increasing levels, so speech does not raise it noticeably
+	if (!_noiseFloorValid) {
+		_noiseFloor = level;
+		_noiseFloorValid = true;
+	} else if (level < _noiseFloor) {
+		_noiseFloor += 0.2 * (level - _noiseFloor);
+	} else {
+		_noiseFloor += 0.002 * (level - _noiseFloor);
+	}
+	if (_noiseFloor < minNoiseFloor) {
+		_noiseFloor = minNoiseFloor;
+	}
+
+	const bool speechFrame = level > minSpeechLevel &&
+				 level > _noiseFloor + noiseFloorMargin &&
+				 zeroCrossingRate >= minZeroCrossingRate &&
+				 zeroCrossingRate <= maxZeroCrossingRate;
+	_recentFrames = ((_recentFrames << 1) | (speechFrame ? 1 : 0)) &
+			onsetFrameMask;
+
+	if (!_speaking) {
+		int count = 0;
+		for (uint32_t frames = _recentFrames; frames; frames >>= 1) {
+			count += frames & 1;
+		}
+		if (count >= onsetFrameCount) {
+			_hangover = hangoverFrames;
+			SetSpeaking(true);
+		}
+		return;
+	}
+
+	if (speechFrame) {
+		_hangover = hangoverFrames;
+	} else if (--_hangover <= 0) {
+		SetSpeaking(false);
+	}
+}
+
+void VoiceActivityDetector::SetSpeaking(bool speaking)
+{
+	_stateChangeTime = now();
+	_speaking = speaking;
+	if (auto data = GetSwitcher()) {
+		data->Wakeup(WakeupEvent::AUDIO_LEVEL);
+	}
+}
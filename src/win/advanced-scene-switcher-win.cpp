@@ -11,7 +11,9 @@
 #include <vector>
 #include <QStringList>
 #include <QRegularExpression>
+#include <QSet>
 #include "..\headers\platform-funcs.hpp"
+#include "..\headers\regex-cache.hpp"
 
 #define MAX_SEARCH 1000
 
@@ -208,8 +210,8 @@ bool isFullscreen(const std::string &title)
 
 void GetProcessList(QStringList &processes)
 {
-
 	HANDLE procSnapshot;
+	QSet<QString> names;
 	PROCESSENTRY32 procEntry;
 
 	procSnapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
@@ -232,9 +234,10 @@ void GetProcessList(QStringList &processes)
 		if (tempexe == "[System Process]") {
 			continue;
 		}
-		if (processes.contains(tempexe)) {
+		if (names.contains(tempexe)) {
 			continue;
 		}
+		names.insert(tempexe);
 		processes.append(tempexe);
 	} while (Process32Next(procSnapshot, &procEntry));
 
@@ -266,11 +269,16 @@ bool isInFocus(const QString &executable)
 	// True if executable switch equals current window
 	bool equals = (executable == file);
 	// True if executable switch matches current window
-	bool matches = file.contains(QRegularExpression(executable));
+	bool matches = file.contains(getRegex(executable));
 
 	return (equals || matches);
 }
 
+bool WindowChangeEventsSupported()
+{
+	return false;
+}
+
 static std::unordered_map<HotkeyType, long> keyTable = {
 	// Chars
 	{HotkeyType::Key_A, 0x41},